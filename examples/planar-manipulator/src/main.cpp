@@ -0,0 +1,149 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <planner.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace pln = planner;
+
+// usage: ./planar-manipulator [number of links] [number of trials] [maximum number of threads]
+int main(int argc, char **argv) {
+  const int DIM = (1 < argc) ? std::stoi(argv[1]) : 7;
+  const int NUM_TRIALS = (2 < argc) ? std::stoi(argv[2]) : 5;
+  const int MAX_THREADS = (3 < argc) ? std::stoi(argv[3]) : std::max<int>(std::thread::hardware_concurrency(), 1);
+  const double ARM_LENGTH = 1.5;
+  const double LINK_RADIUS = 0.03;
+  const double EXPAND_DIST = 1.0;
+
+  //--- world (circles around the arm)
+  pln::EuclideanSpace world_space(2);
+  std::vector<pln::Bound> world_bounds{pln::Bound(-2.0, 2.0), pln::Bound(-2.0, 2.0)};
+  world_space.setBound(world_bounds);
+
+  //--- joint space and arm (start: stretched to the right, goal: stretched to the left)
+  pln::EuclideanSpace space(DIM);
+  std::vector<pln::Bound> bounds(DIM, pln::Bound(-M_PI, M_PI));
+  space.setBound(bounds);
+
+  pln::State start(std::vector<double>(DIM, 0.0));
+  pln::State goal(std::vector<double>(DIM, 0.0));
+  goal.vals[0] = 0.9 * M_PI;
+
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<double> dist_angle(0.2 * M_PI, 0.8 * M_PI);
+  std::uniform_real_distribution<double> dist_radius(1.0, 1.4);
+  std::shared_ptr<pln::ManipulatorConstraint> constraint;
+  while (constraint == nullptr || constraint->checkConstraintType(start) == pln::ConstraintType::NOENTRY ||
+         constraint->checkConstraintType(goal) == pln::ConstraintType::NOENTRY) {
+    std::vector<pln::PointCloudConstraint::Hypersphere> obstacles;
+    for (int i = 0; i < 8; i++) {
+      const auto angle = dist_angle(engine);
+      const auto radius = dist_radius(engine);
+      obstacles.emplace_back(pln::State(radius * std::cos(angle), radius * std::sin(angle)), 0.08);
+    }
+    auto world = std::make_shared<pln::PointCloudConstraint>(world_space, obstacles);
+    constraint = std::make_shared<pln::ManipulatorConstraint>(space, pln::State(0.0, 0.0),
+                                                              std::vector<double>(DIM, ARM_LENGTH / DIM),
+                                                              LINK_RADIUS, world);
+  }
+  constraint->setResolution(0.02);
+
+  //--- solve by each planner
+  std::cout << "links: " << DIM << ", trials: " << NUM_TRIALS << std::endl;
+  for (int type = 0; type < 3; type++) {
+    int num_success = 0;
+    double total_time = 0;
+    double total_cost = 0;
+    uint64_t total_checks = 0;
+    std::string name;
+    for (int trial = 0; trial < NUM_TRIALS; trial++) {
+      std::unique_ptr<pln::base::PlannerBase> planner;
+      switch (type) {
+        case 0:
+          planner = std::make_unique<pln::RRT>(DIM, 20000, 0.05, EXPAND_DIST);
+          name = "RRT";
+          break;
+        case 1:
+          planner = std::make_unique<pln::RRTStar>(DIM, 10000, 0.05, EXPAND_DIST, 10.0);
+          name = "RRT*";
+          break;
+        default:
+          planner = std::make_unique<pln::InformedRRTStar>(DIM, 10000, 0.05, EXPAND_DIST, 10.0, EXPAND_DIST);
+          name = "Informed-RRT*";
+          break;
+      }
+      planner->setProblemDefinition(constraint);
+
+      const auto start_time = std::chrono::steady_clock::now();
+      const auto status = planner->solve(start, goal);
+      const auto end_time = std::chrono::steady_clock::now();
+
+      total_time += std::chrono::duration<double, std::milli>(end_time - start_time).count();
+      total_checks += planner->getStatistics().num_collision_checks;
+      if (status) {
+        num_success++;
+        total_cost += planner->getResultCost();
+      }
+    }
+
+    std::cout << name << ": success " << num_success << "/" << NUM_TRIALS << ", time "
+              << total_time / NUM_TRIALS << " [ms], collision checks " << total_checks / NUM_TRIALS;
+    if (0 < num_success) {
+      std::cout << ", cost " << total_cost / num_success;
+    }
+    std::cout << std::endl;
+  }
+
+  //--- speedup of RRT* against the number of threads which check collision of near nodes
+  std::cout << std::endl << "RRT* with threads" << std::endl;
+  double single_thread_time = 0;
+  for (int num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+    double total_time = 0;
+    for (int trial = 0; trial < NUM_TRIALS; trial++) {
+      pln::RRTStar planner(DIM, 10000, 0.05, EXPAND_DIST, 10.0);
+      planner.setProblemDefinition(constraint);
+      planner.setNumThreads(num_threads);
+
+      const auto start_time = std::chrono::steady_clock::now();
+      planner.solve(start, goal);
+      const auto end_time = std::chrono::steady_clock::now();
+      total_time += std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    }
+
+    if (num_threads == 1) {
+      single_thread_time = total_time;
+    }
+    std::cout << "threads " << num_threads << ": time " << total_time / NUM_TRIALS << " [ms], speedup "
+              << single_thread_time / total_time << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_BVH_BVH_H_
+#define LIB_INCLUDE_BVH_BVH_H_
+
+#include <State/State.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace planner {
+/**
+ *  Bounding volume hierarchy which consists of axis-aligned bounding boxes
+ *  Primitives are referred by index, and the boxes of primitives are given
+ *  as flat arrays (i.e., bound of primitive 'i' is stored in [i * dim, (i + 1) * dim))
+ */
+class BVH {
+ public:
+  /**
+   *  Callback for traversal
+   *  @begin:  begin of leaf range on getOrderRef()
+   *  @end:    end of leaf range on getOrderRef()
+   *  @Return: whether the traversal should be continued
+   */
+  using LeafCallback = std::function<bool(const uint32_t &begin, const uint32_t &end)>;
+
+  /**
+   *  Callback for nearest traversal
+   *  @begin:  begin of leaf range on getOrderRef()
+   *  @end:    end of leaf range on getOrderRef()
+   *  @Return: distance to the nearest primitive in the leaf
+   *           (must not be less than distance to the box of the primitive)
+   */
+  using DistanceCallback = std::function<double(const uint32_t &begin, const uint32_t &end)>;
+
+  /**
+   *  Constructor(BVH)
+   *  @dim:       dimension of boxes
+   *  @leaf_size: maximum number of primitives in a leaf
+   */
+  explicit BVH(const uint32_t &dim, const uint32_t &leaf_size = 4);
+  ~BVH();
+
+  /**
+   *  Build hierarchy from the boxes of primitives
+   *  @lows:  lower corners of primitives
+   *  @highs: upper corners of primitives
+   */
+  void build(const std::vector<double> &lows, const std::vector<double> &highs);
+
+  void clear();
+
+  uint32_t getDim() const;
+
+  uint32_t getSize() const;
+
+  /**
+   *  Primitive indices sorted in leaf order
+   *  (each leaf refers to a contiguous range of this array)
+   */
+  const std::vector<uint32_t> &getOrderRef() const;
+
+  /**
+   *  Visit leaves whose box overlaps the segment between src and dst
+   *  @src:      source state
+   *  @dst:      destination state
+   *  @callback: called at each leaf
+   *  @Return:   false if the callback stopped the traversal
+   */
+  bool traverseSegment(const State &src, const State &dst, const LeafCallback &callback) const;
+
+  /**
+   *  Visit leaves whose box contains the state
+   *  @state:    target state
+   *  @callback: called at each leaf
+   *  @Return:   false if the callback stopped the traversal
+   */
+  bool traversePoint(const State &state, const LeafCallback &callback) const;
+
+  /**
+   *  Visit leaves whose box overlaps the box between low and high
+   *  @low:      lower corner of the box
+   *  @high:     upper corner of the box
+   *  @callback: called at each leaf
+   *  @Return:   false if the callback stopped the traversal
+   */
+  bool traverseBox(const State &low, const State &high, const LeafCallback &callback) const;
+
+  /**
+   *  Visit leaves in order of distance from the state while they can be nearer than the nearest found so far
+   *  @state:       target state
+   *  @upper_bound: leaves farther than this distance are not visited
+   *  @callback:    called at each leaf
+   *  @Return:      minimum of 'upper_bound' and the values returned by the callback
+   */
+  double traverseNearest(const State &state, const double &upper_bound, const DistanceCallback &callback) const;
+
+  /**
+   *  Update the box of a primitive and refit the boxes of its ancestors
+   *  (topology of the hierarchy is kept, so the quality of culling may degrade)
+   *  @order_idx: index of the primitive on getOrderRef()
+   *  @low:       new lower corner of the primitive
+   *  @high:      new upper corner of the primitive
+   */
+  void refit(const uint32_t &order_idx, const std::vector<double> &low, const std::vector<double> &high);
+
+ private:
+  // depth of median split hierarchy never exceeds log2 of the number of primitives
+  static constexpr uint32_t MAX_STACK_SIZE = 64;
+
+  struct BVHNode {
+    int32_t parent;
+    int32_t left;
+    int32_t right;
+    uint32_t begin;
+    uint32_t end;
+    BVHNode() : parent(-1), left(-1), right(-1), begin(0), end(0) {}
+  };
+
+  const uint32_t dim_;
+  const uint32_t leaf_size_;
+
+  std::vector<BVHNode> nodes_;
+  std::vector<double> bounds_;
+  std::vector<uint32_t> order_;
+
+  // boxes of primitives and the leaf which contains each primitive in leaf order
+  std::vector<double> prim_bounds_;
+  std::vector<int32_t> prim_leaf_;
+
+  int32_t buildRec(const std::vector<double> &lows, const std::vector<double> &highs, const uint32_t &begin,
+                   const uint32_t &end, const int32_t &parent);
+
+  void fitLeaf(const int32_t &node_idx);
+
+  void fitInternal(const int32_t &node_idx);
+
+  bool overlapSegment(const int32_t &node_idx, const State &src, const std::vector<double> &inv_dir) const;
+
+  bool containPoint(const int32_t &node_idx, const State &state) const;
+
+  bool overlapBox(const int32_t &node_idx, const State &low, const State &high) const;
+
+  double calcSquaredDistance(const int32_t &node_idx, const State &state) const;
+
+  bool traverse(const std::function<bool(const int32_t &)> &is_overlapped, const LeafCallback &callback) const;
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_BVH_BVH_H_ */
@@ -0,0 +1,142 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_COMPOSITECONSTRAINT_COMPOSITECONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_COMPOSITECONSTRAINT_COMPOSITECONSTRAINT_H_
+
+#include <Constraint/ConstraintBase.h>
+#include <State/State.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::ConstraintBase
+ *  This class express constraint as union of several constraints
+ *  Constraints are evaluated in ascending order of measured time per reject
+ *  and the evaluation stops at the first constraint which rejects the query
+ */
+class CompositeConstraint : public base::ConstraintBase {
+ public:
+  using ConstraintPtr = std::shared_ptr<base::ConstraintBase>;
+
+  /**
+   *  Constructor(CompositeConstraint)
+   *  @space: target space
+   */
+  explicit CompositeConstraint(const EuclideanSpace &space);
+
+  /**
+   *  Constructor(CompositeConstraint)
+   *  @space:       target space
+   *  @constraints: constraints to combine
+   *                if dimension of constraint different from dimension of space,
+   *                this constructor throw std::invalid_argument
+   */
+  CompositeConstraint(const EuclideanSpace &space, const std::vector<ConstraintPtr> &constraints);
+
+  ~CompositeConstraint() override;
+
+  void set(const std::vector<ConstraintPtr> &constraints);
+
+  void add(const ConstraintPtr &constraint);
+
+  const std::vector<ConstraintPtr> &getConstraintsRef() const;
+
+  /**
+   *  Current order of evaluation
+   *  @for_collision: order for checkCollision() if true, otherwise for checkConstraintType()
+   *  @Return:        indices on getConstraintsRef()
+   */
+  std::vector<size_t> getOrder(const bool &for_collision = true) const;
+
+  void resetStatistics();
+
+  bool checkCollision(const State &src, const State &dst) const override;
+
+  /**
+   *  The source state meets all constraints, so that each constraint skips it as well
+   */
+  bool checkCollisionFromValidState(const State &src, const State &dst) const override;
+
+  /**
+   *  Each constraint checks the edges which are not rejected yet by its checkCollisionBatch() in current order
+   */
+  void checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                           std::vector<bool> &results) const override;
+
+  ConstraintType checkConstraintType(const State &state) const override;
+
+  /**
+   *  Maximum edge cost of all constraints (distance if there is no constraint)
+   */
+  double calcEdgeCost(const State &src, const State &dst) const override;
+
+  /**
+   *  Minimum clearance of all constraints
+   */
+  double clearance(const State &state) const override;
+
+ private:
+  // order of evaluation is updated every this number of queries
+  static constexpr uint64_t REORDER_INTERVAL = 256;
+
+  enum QueryType { COLLISION = 0, CONSTRAINT_TYPE = 1, NUM_QUERY_TYPES = 2 };
+
+  struct Statistics {
+    std::atomic<uint64_t> num_rejects;
+    std::atomic<uint64_t> elapsed_ns;
+  };
+
+  std::vector<ConstraintPtr> constraints_;
+
+  // statistics and order of evaluation of each query type
+  // (order is replaced atomically so that concurrent queries always see a complete order)
+  std::unique_ptr<Statistics[]> stats_[NUM_QUERY_TYPES];
+  mutable std::shared_ptr<const std::vector<size_t>> order_[NUM_QUERY_TYPES];
+  mutable std::atomic<uint64_t> num_queries_[NUM_QUERY_TYPES];
+
+  /**
+   *  Evaluate constraints in current order until one of them rejects
+   *  @type:    query type
+   *  @is_free: evaluation of a constraint
+   *  @Return:  If all constraints accept, return true
+   */
+  bool evaluate(const QueryType &type, const std::function<bool(const base::ConstraintBase &)> &is_free) const;
+
+  /**
+   *  Sort constraints by time per reject (a constraint which has never rejected is evaluated last),
+   *  and halve statistics so that the order follows recent queries
+   *  @type: query type
+   */
+  void reorder(const QueryType &type) const;
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_COMPOSITECONSTRAINT_COMPOSITECONSTRAINT_H_ */
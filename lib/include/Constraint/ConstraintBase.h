@@ -29,6 +29,7 @@
 #include <State/State.h>
 
 #include <cstdint>
+#include <vector>
 
 namespace planner {
 
@@ -55,8 +56,19 @@ class ConstraintBase {
 
   uint32_t getDim() const;
 
+  /**
+   *  Resolution of edge subdivision in default checkCollision()
+   *  @resolution: maximum distance between checked states
+   *               (if it is not positive, 1% of the smallest range of space is used)
+   */
+  void setResolution(const double &resolution);
+
+  double getResolution() const;
+
   /**
    *  Check whether collision occurred between src and dst
+   *  Default implementation checks states on the edge at intervals of getResolution()
+   *  by checkConstraintType(), in bisection (van der Corput) order after both ends
    *  @src:    source state
    *  @dst:    destination state
    *  @Return: If the path of between 'src' and 'dst' entry
@@ -64,12 +76,72 @@ class ConstraintBase {
    */
   virtual bool checkCollision(const State &src, const State &dst) const;
 
+  /**
+   *  Check collision of the edge whose source state is known to meet constraint
+   *  Default implementation calls checkCollision(), so that the source state is checked again
+   *  and only a class which overrides this function skips it (e.g. by calling checkSubdividedEdge())
+   *  (skipping it by default would bypass checkCollision() of a class which overrides only that function)
+   *  @src:    source state which meets constraint
+   *  @dst:    destination state
+   *  @Return: whether the edge meets constraint
+   */
+  virtual bool checkCollisionFromValidState(const State &src, const State &dst) const;
+
+  /**
+   *  Check collision of edges which share the source state
+   *  (default implementation checks the source state once and calls checkCollisionFromValidState() for each edge)
+   *  @src:     source state
+   *  @dsts:    destination states
+   *  @results: results of checkCollision() for each destination
+   */
+  virtual void checkCollisionBatch(const State &src, const std::vector<State> &dsts, std::vector<bool> &results) const;
+
   /**
    *  Check constraint at given state
    *  @state: target state
    *  @Return: type of constraint at target state
    */
   virtual ConstraintType checkConstraintType(const State &state) const;
+
+  /**
+   *  Cost of moving along the edge between src and dst
+   *  (it must not be less than the distance so that the distance is admissible heuristic,
+   *   default implementation returns the distance)
+   *  @src:    source state
+   *  @dst:    destination state
+   *  @Return: cost of the edge
+   */
+  virtual double calcEdgeCost(const State &src, const State &dst) const;
+
+  /**
+   *  Lower bound of distance from given state to the nearest obstacle (including outside of space)
+   *  Any state closer to 'state' than the clearance meets the constraint
+   *  (default implementation has no information and returns zero)
+   *  @state:  target state
+   *  @Return: clearance (zero if the state does not meet the constraint)
+   */
+  virtual double clearance(const State &state) const;
+
+ protected:
+  /**
+   *  Interior points of the edge to check at intervals of getResolution()
+   *  (bit reversed order so that the interval between checked points is halved at every level)
+   *  @dist:   length of the edge
+   *  @Return: parameter in (0, 1) of each point
+   */
+  std::vector<double> calcSubdivisionOrder(const double &dist) const;
+
+  /**
+   *  Check the destination state and the states on the edge at intervals of getResolution()
+   *  by checkConstraintType() (the source state is not checked)
+   *  @src:    source state
+   *  @dst:    destination state
+   *  @Return: whether the checked states meet constraint
+   */
+  bool checkSubdividedEdge(const State &src, const State &dst) const;
+
+ private:
+  double resolution_;
 };
 }  // namespace base
 }  // namespace planner
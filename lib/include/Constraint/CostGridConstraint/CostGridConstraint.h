@@ -0,0 +1,91 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_COSTGRIDCONSTRAINT_COSTGRIDCONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_COSTGRIDCONSTRAINT_COSTGRIDCONSTRAINT_H_
+
+#include <Constraint/GridConstraint/GridConstraint.h>
+#include <State/State.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::GridConstraint
+ *  This class has cost of traversal for each cell in addition to the type of constraint,
+ *  and cost of an edge is line integral of the cost of cells along the edge
+ *  For each cell, the largest uniform block (aligned block of 2^level cells on each axis whose cells have
+ *  the same cost) which contains the cell is precomputed, and the integral jumps over the block at once
+ */
+class CostGridConstraint : public GridConstraint {
+ public:
+  /**
+   *  Constructor(CostGridConstraint)
+   *  @space: target space
+   */
+  explicit CostGridConstraint(const EuclideanSpace &space);
+
+  /**
+   *  Constructor(CostGridConstraint)
+   *  @space:         target space
+   *  @constraint:    multidimensional array express as one dimensional array
+   *                  (e.g. '(x, y)' -> 'x + y * x_size' where 2 dimensions)
+   *  @each_dim_size: each dimension size of constraint you set
+   *  @costs:         cost per unit length of each cell in the same order as 'constraint'
+   *                  (if size is different from 'constraint' or any cost is less than 1,
+   *                   throw std::invalid_argument)
+   */
+  CostGridConstraint(const EuclideanSpace &space, const std::vector<ConstraintType> &constraint,
+                     const std::vector<uint32_t> &each_dim_size, const std::vector<double> &costs);
+
+  ~CostGridConstraint() override;
+
+  void set(const std::vector<ConstraintType> &constraint, const std::vector<uint32_t> &each_dim_size,
+           const std::vector<double> &costs);
+
+  const std::vector<double> &getCostsRef() const;
+
+  /**
+   *  Line integral of cost along the edge
+   *  (if either end is out of space, return the maximum value of double,
+   *   and if the grid is reset by GridConstraint::set() without costs, throw std::invalid_argument)
+   */
+  double calcEdgeCost(const State &src, const State &dst) const override;
+
+ private:
+  std::vector<double> costs_;
+
+  // level of the largest uniform block which contains each cell
+  std::vector<uint8_t> uniform_levels_;
+
+  /**
+   *  Calculate uniform_levels_ from the min/max pyramid of costs
+   */
+  void calcUniformLevels();
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_COSTGRIDCONSTRAINT_COSTGRIDCONSTRAINT_H_ */
@@ -28,6 +28,8 @@
 #include <Constraint/ConstraintBase.h>
 #include <State/State.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <iostream>
 #include <vector>
@@ -65,19 +67,48 @@ class GridConstraint : public base::ConstraintBase {
 
   const std::vector<uint32_t> &getEachDimSizeRef() const;
 
+  /**
+   *  Offset of the index of constraint array per cell along each dimension
+   */
+  const std::vector<uint32_t> &getStridesRef() const;
+
   State calcGridIdx(const State &state) const;
 
   std::vector<std::vector<uint32_t>> calcLineIndices(State src_idx, State dst_idx) const;
 
   bool checkCollision(const State &src, const State &dst) const override;
 
+  /**
+   *  Check collision of edges which share the source state
+   *  (the source index is calculated only once)
+   */
+  void checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                           std::vector<bool> &results) const override;
+
   ConstraintType checkConstraintType(const State &state) const override;
 
   ConstraintType checkConstraintType(const std::vector<uint32_t> &idx) const;
 
+  /**
+   *  Distance to the nearest NOENTRY cell or the boundary of space
+   *  (distance between cell centers is looked up from the distance field calculated in set(),
+   *   and the diagonal of a cell is subtracted so that the value is a lower bound)
+   */
+  double clearance(const State &state) const override;
+
  private:
   std::vector<ConstraintType> constraint_;
   std::vector<uint32_t> each_dim_size_;
+  std::vector<uint32_t> strides_;
+
+  // squared distance from the center of each cell to the center of the nearest NOENTRY cell
+  std::vector<double> sq_dist_field_;
+  double cell_diagonal_;
+
+  /**
+   *  Calculate sq_dist_field_ by separable exact euclidean distance transform
+   */
+  void calcDistanceField();
 };
 }  // namespace planner
 
@@ -0,0 +1,125 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_MANIPULATORCONSTRAINT_MANIPULATORCONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_MANIPULATORCONSTRAINT_MANIPULATORCONSTRAINT_H_
+
+#include <Constraint/ConstraintBase.h>
+#include <Constraint/PointCloudConstraint/PointCloudConstraint.h>
+#include <Constraint/PolygonConstraint/PolygonConstraint.h>
+#include <State/State.h>
+
+#include <Eigen/Dense>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::ConstraintBase
+ *  This class express constraint on the joint space of a planar N-link arm among 2 dimensional obstacles
+ *  Each dimension of the space is the angle of a joint relative to the previous link,
+ *  and each link is a capsule which must not touch the obstacles of the world
+ *  (self collision is not considered)
+ */
+class ManipulatorConstraint : public base::ConstraintBase {
+ public:
+  /**
+   *  Constructor(ManipulatorConstraint)
+   *  @space:        joint space (dimension is the number of links)
+   *  @base:         position of the first joint in the world
+   *  @link_lengths: length of each link from the base
+   *  @link_radius:  radius of the capsule of links
+   *  @world:        obstacles in the 2 dimensional world
+   *                 (if any argument is invalid, throw std::invalid_argument)
+   */
+  ManipulatorConstraint(const EuclideanSpace &space, const State &base, const std::vector<double> &link_lengths,
+                        const double &link_radius, const std::shared_ptr<const PointCloudConstraint> &world);
+
+  ManipulatorConstraint(const EuclideanSpace &space, const State &base, const std::vector<double> &link_lengths,
+                        const double &link_radius, const std::shared_ptr<const PolygonConstraint> &world);
+
+  ~ManipulatorConstraint() override;
+
+  const State &getBaseRef() const;
+  const std::vector<double> &getLinkLengthsRef() const;
+  double getLinkRadius() const;
+
+  /**
+   *  Forward kinematics
+   *  @state:  configuration
+   *  @Return: positions of the base, each joint and the end effector
+   */
+  std::vector<State> calcForwardKinematics(const State &state) const;
+
+  /**
+   *  Forward kinematics of configurations at once
+   *  @states: configurations (each row is a configuration)
+   *  @xs:     x coordinates (row 'i' corresponds to configuration 'i',
+   *           column 0 is the base and column 'j' is the end of link 'j')
+   *  @ys:     y coordinates in the same layout as 'xs'
+   */
+  void calcForwardKinematics(const Eigen::MatrixXd &states, Eigen::MatrixXd &xs, Eigen::MatrixXd &ys) const;
+
+  /**
+   *  Configurations on the edge are checked at intervals of getResolution() in bit reversed order,
+   *  and forward kinematics is calculated for BATCH_SIZE configurations at once
+   */
+  bool checkCollision(const State &src, const State &dst) const override;
+
+  bool checkCollisionFromValidState(const State &src, const State &dst) const override;
+
+  ConstraintType checkConstraintType(const State &state) const override;
+
+ private:
+  // number of configurations whose forward kinematics is calculated at once
+  static constexpr int BATCH_SIZE = 16;
+
+  using LinkChecker = std::function<bool(const State &, const State &)>;
+
+  State base_;
+  std::vector<double> link_lengths_;
+  double link_radius_;
+
+  // the world is kept alive while the checker refers it
+  std::shared_ptr<const base::ConstraintBase> world_;
+  LinkChecker is_link_free_;
+
+  ManipulatorConstraint(const EuclideanSpace &space, const State &base, const std::vector<double> &link_lengths,
+                        const double &link_radius, const std::shared_ptr<const base::ConstraintBase> &world,
+                        const LinkChecker &is_link_free);
+
+  /**
+   *  Check whether all links of a configuration are free
+   *  @xs:     x coordinates calculated by calcForwardKinematics()
+   *  @ys:     y coordinates calculated by calcForwardKinematics()
+   *  @row:    index of the configuration
+   *  @Return: If no link touches obstacles, return true
+   */
+  bool checkLinks(const Eigen::MatrixXd &xs, const Eigen::MatrixXd &ys, const Eigen::Index &row) const;
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_MANIPULATORCONSTRAINT_MANIPULATORCONSTRAINT_H_ */
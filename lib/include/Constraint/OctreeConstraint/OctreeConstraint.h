@@ -0,0 +1,132 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_OCTREECONSTRAINT_OCTREECONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_OCTREECONSTRAINT_OCTREECONSTRAINT_H_
+
+#include <Constraint/ConstraintBase.h>
+#include <State/State.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::ConstraintBase
+ *  This class express constraint as occupancy octree in 3 dimensional space
+ *  Each node is a 32 bit word which packs its state and the index of the block of its 8 children,
+ *  and 8 children which have the same state are merged into their parent,
+ *  so that memory scales with the surface of occupied region
+ */
+class OctreeConstraint : public base::ConstraintBase {
+ public:
+  /**
+   *  Constructor(OctreeConstraint)
+   *  All space is initialized to be unknown
+   *  @space:     target space (if dimension of space is not 3, throw std::invalid_argument)
+   *  @leaf_size: edge length of the smallest octant
+   */
+  OctreeConstraint(const EuclideanSpace &space, const double &leaf_size);
+
+  ~OctreeConstraint() override;
+
+  /**
+   *  Make all space unknown
+   */
+  void clear();
+
+  /**
+   *  Set occupancy of the smallest octant which contains the state
+   *  (if the state is out of space, throw std::invalid_argument)
+   *  @state:    target state
+   *  @occupied: the octant becomes occupied if true, otherwise free
+   */
+  void setOccupied(const State &state, const bool &occupied = true);
+
+  /**
+   *  Type of constraint of octants which are neither occupied nor free
+   *  (ConstraintType::ENTAERABLE by default)
+   */
+  void setUnknownType(const ConstraintType &unknown_type);
+  ConstraintType getUnknownType() const;
+
+  double getLeafSize() const;
+
+  /**
+   *  Depth of the tree (the root octant is 2^depth times as large as the smallest octant)
+   */
+  uint32_t getDepth() const;
+
+  /**
+   *  Number of nodes in use
+   */
+  size_t getNumNodes() const;
+
+  bool checkCollision(const State &src, const State &dst) const override;
+
+  ConstraintType checkConstraintType(const State &state) const override;
+
+ private:
+  static constexpr uint32_t MAX_DEPTH = 21;
+  static constexpr uint32_t STATE_BITS = 2;
+  static constexpr uint32_t STATE_MASK = (1u << STATE_BITS) - 1;
+
+  // state of node (INNER means that the node has children)
+  enum NodeState : uint32_t { FREE = 0, UNKNOWN = 1, OCCUPIED = 2, INNER = 3 };
+
+  const double leaf_size_;
+  uint32_t depth_;
+  std::array<double, 3> origin_;
+  ConstraintType unknown_type_;
+
+  // root is nodes_[0], and block 'b' of children is nodes_[1 + 8 * b] to nodes_[8 + 8 * b]
+  // (each node is 'state | block << STATE_BITS')
+  std::vector<uint32_t> nodes_;
+  std::vector<uint32_t> free_blocks_;
+
+  /**
+   *  Whether the octant which has the state blocks the query
+   */
+  bool isBlocked(const uint32_t &state) const;
+
+  /**
+   *  Key of the smallest octant which contains the state
+   *  @Return: false if the state is out of space
+   */
+  bool calcKey(const State &state, std::array<uint32_t, 3> &key) const;
+
+  void updateLeaf(const std::array<uint32_t, 3> &key, const NodeState &state);
+
+  uint32_t allocateBlock(const NodeState &state);
+
+  static uint32_t getState(const uint32_t &node);
+
+  static uint32_t getChild(const uint32_t &node, const uint32_t &child_idx);
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_OCTREECONSTRAINT_OCTREECONSTRAINT_H_ */
@@ -25,17 +25,25 @@
 #ifndef LIB_INCLUDE_CONSTRAINT_POINTCLOUDCONSTRAINT_POINTCLOUDCONSTRAINT_H_
 #define LIB_INCLUDE_CONSTRAINT_POINTCLOUDCONSTRAINT_POINTCLOUDCONSTRAINT_H_
 
+#include <BVH/BVH.h>
 #include <Constraint/ConstraintBase.h>
 #include <State/State.h>
 
+#include <Eigen/Dense>
 #include <algorithm>
 #include <numeric>
+#include <unordered_map>
 
 namespace planner {
 
 /**
  *  Super class of planner::ConstraintBase
  *  This class express constraint as set of hypersphere
+ *  and hyperspheres are indexed by BVH to cull obstacles far from the query
+ *  (centers and squared radii are stored as structure of arrays in leaf order
+ *   so that a leaf is evaluated by a vectorized kernel)
+ *  Each hypersphere has an id, and it can be added, removed and moved
+ *  without rebuilding BVH until the number of updates reaches certain ratio
  */
 class PointCloudConstraint : public base::ConstraintBase {
  public:
@@ -89,16 +97,145 @@ class PointCloudConstraint : public base::ConstraintBase {
 
   ~PointCloudConstraint() override;
 
+  /**
+   *  Replace all hyperspheres
+   *  (ids are reassigned to the index of each hypersphere in 'constraint')
+   */
   void set(const std::vector<Hypersphere> &constraint);
+  void set(std::vector<Hypersphere> &&constraint);
 
+  /**
+   *  Add a hypersphere
+   *  @hypersphere: hypersphere to add
+   *  @Return:      id of the added hypersphere
+   */
+  uint32_t add(const Hypersphere &hypersphere);
+
+  /**
+   *  Remove a hypersphere
+   *  @id: id of the hypersphere to remove
+   *       (if there is no hypersphere which has the id, throw std::invalid_argument)
+   */
+  void remove(const uint32_t &id);
+
+  /**
+   *  Move the center of a hypersphere
+   *  @id:    id of the hypersphere to move
+   *          (if there is no hypersphere which has the id, throw std::invalid_argument)
+   *  @state: new center of the hypersphere
+   */
+  void move(const uint32_t &id, const State &state);
+
+  /**
+   *  Reference to current hyperspheres
+   *  (the order changes when a hypersphere is removed)
+   */
   const std::vector<Hypersphere> &getRef() const;
 
+  /**
+   *  Reference to ids of current hyperspheres (correspond with getRef())
+   */
+  const std::vector<uint32_t> &getIdsRef() const;
+
   bool checkCollision(const State &src, const State &dst) const override;
 
+  /**
+   *  Check collision of the capsule which is the segment inflated by 'margin'
+   *  (BVH is traversed with the bounding box of the capsule)
+   *  @margin: radius of the capsule
+   *  @Return: If the capsule touches no hypersphere, return true
+   */
+  bool checkCollision(const State &src, const State &dst, const double &margin) const;
+
+  /**
+   *  Check collision of edges which share the source state
+   *  (BVH is traversed once with the bounding box of all edges,
+   *   and then each block of hyperspheres is tested against every remaining edge)
+   */
+  void checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                           std::vector<bool> &results) const override;
+
   ConstraintType checkConstraintType(const State &state) const override;
 
+  /**
+   *  Distance to the surface of the nearest hypersphere or the boundary of space
+   *  (the nearest hypersphere is searched by BVH)
+   */
+  double clearance(const State &state) const override;
+
  private:
+  // number of hyperspheres evaluated by the kernel at once
+  static constexpr int KERNEL_WIDTH = 8;
+
+  using KernelArray = Eigen::Array<double, KERNEL_WIDTH, 1>;
+
+  // BVH is rebuilt when the number of pending and removed hyperspheres
+  // exceeds this ratio of indexed hyperspheres
+  static constexpr double REBUILD_RATIO = 0.1;
+
+  struct Entry {
+    uint32_t index;  // index on constraint_
+    uint32_t slot;   // column on centers_ and sq_radii_
+  };
+
   std::vector<Hypersphere> constraint_;
+  std::vector<uint32_t> ids_;
+  std::unordered_map<uint32_t, Entry> entries_;
+  uint32_t next_id_;
+
+  BVH bvh_;
+
+  // each row is the coordinate on a dimension, and each column is a hypersphere
+  // [0, num_indexed_) is in leaf order of bvh_, [num_indexed_, num_slots_) is
+  // pending hyperspheres added after building, and the rest never collide
+  // (removed hypersphere has negative squared radius so that it never collides)
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> centers_;
+  Eigen::ArrayXd sq_radii_;
+  uint32_t num_indexed_;
+  uint32_t num_slots_;
+  uint32_t num_removed_;
+
+  /**
+   *  Rebuild BVH and the structure of arrays from constraint_
+   */
+  void rebuild();
+
+  /**
+   *  Rebuild when there are too many pending or removed hyperspheres
+   */
+  void rebuildIfDegraded();
+
+  /**
+   *  Extend the structure of arrays so that 'num_slots' slots and padding are available
+   */
+  void reserveSlots(const uint32_t &num_slots);
+
+  const Entry &getEntry(const uint32_t &id) const;
+
+  /**
+   *  Check whether the segment touches hyperspheres in [begin, end) of leaf order
+   *  @src:      source state
+   *  @dir:      'dst' - 'src'
+   *  @inv_len2: inverse of squared length of 'dir' (zero when 'src' equals 'dst')
+   *  @margin:   distance to keep from hyperspheres
+   *  @Return:   If the segment touches any hypersphere, return false
+   */
+  bool checkSegmentKernel(const State &src, const State &dir, const double &inv_len2, const uint32_t &begin,
+                          const uint32_t &end, const double &margin = 0.0) const;
+
+  /**
+   *  Check whether the state is inside hyperspheres in [begin, end) of leaf order
+   *  @state:  target state
+   *  @Return: If the state is inside any hypersphere, return false
+   */
+  bool checkPointKernel(const State &state, const uint32_t &begin, const uint32_t &end) const;
+
+  /**
+   *  Distance from the state to the surface of the nearest hypersphere in [begin, end) of leaf order
+   *  @state:  target state
+   *  @Return: minimum distance (negative if the state is inside a hypersphere)
+   */
+  double calcDistanceKernel(const State &state, const uint32_t &begin, const uint32_t &end) const;
 };
 }  // namespace planner
 
@@ -0,0 +1,150 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_POLYGONCONSTRAINT_POLYGONCONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_POLYGONCONSTRAINT_POLYGONCONSTRAINT_H_
+
+#include <BVH/BVH.h>
+#include <Constraint/ConstraintBase.h>
+#include <State/State.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::ConstraintBase
+ *  This class express constraint as set of polygon in 2 dimensional space
+ *  Edges of polygons are indexed by BVH for exact segment-segment intersection,
+ *  and polygons are indexed by another BVH for point-in-polygon test by winding number
+ */
+class PolygonConstraint : public base::ConstraintBase {
+ public:
+  /**
+   *  Simple polygon (convex or not) as a way of expressing of Obstacle
+   */
+  class Polygon {
+   public:
+    /**
+     *  Constructor(Polygon)
+     *  @vertices: vertices in clockwise or counterclockwise order
+     *             (if the number of vertices is less than 3 or any vertex is not 2 dimensional,
+     *              throw std::invalid_argument)
+     */
+    explicit Polygon(const std::vector<State> &vertices);
+
+    const std::vector<State> &getVerticesRef() const;
+
+   private:
+    std::vector<State> vertices_;
+  };
+
+  /**
+   *  Constructor(PolygonConstraint)
+   *  @space: target space (if dimension of space is not 2, throw std::invalid_argument)
+   */
+  explicit PolygonConstraint(const EuclideanSpace &space);
+
+  /**
+   *  Constructor(PolygonConstraint)
+   *  @space:    target space (if dimension of space is not 2, throw std::invalid_argument)
+   *  @polygons: set of polygon
+   */
+  PolygonConstraint(const EuclideanSpace &space, const std::vector<Polygon> &polygons);
+
+  ~PolygonConstraint() override;
+
+  void set(const std::vector<Polygon> &polygons);
+
+  const std::vector<Polygon> &getRef() const;
+
+  bool checkCollision(const State &src, const State &dst) const override;
+
+  /**
+   *  Check collision of the capsule which is the segment inflated by 'margin'
+   *  (edges are searched by BVH with the bounding box of the capsule)
+   *  @margin: radius of the capsule
+   *  @Return: If the capsule touches no polygon, return true
+   */
+  bool checkCollision(const State &src, const State &dst, const double &margin) const;
+
+  ConstraintType checkConstraintType(const State &state) const override;
+
+  /**
+   *  Distance to the nearest edge of polygons or the boundary of space
+   *  (the nearest edge is searched by BVH)
+   */
+  double clearance(const State &state) const override;
+
+ private:
+  // segment as (x0, y0, x1, y1)
+  using Edge = std::array<double, 4>;
+
+  std::vector<Polygon> polygons_;
+
+  // primitive 'i' of edge_bvh_ is edges_[i], and primitive 'i' of polygon_bvh_ is polygons_[i]
+  std::vector<Edge> edges_;
+  BVH edge_bvh_;
+  BVH polygon_bvh_;
+
+  /**
+   *  Check whether the state is inside the polygon (including its boundary) by winding number
+   */
+  static bool containPoint(const Polygon &polygon, const State &state);
+
+  /**
+   *  Check whether two segments intersect (including touching and collinear overlap)
+   */
+  static bool intersectSegment(const Edge &edge, const State &src, const State &dst);
+
+  /**
+   *  Cross product of (a - o) and (b - o)
+   *  (positive if 'o', 'a', 'b' are in counterclockwise order)
+   */
+  static double calcCross(const double &ox, const double &oy, const double &ax, const double &ay, const double &bx,
+                          const double &by);
+
+  /**
+   *  Whether the point 'p' which is collinear with the segment between 'a' and 'b' lies on the segment
+   */
+  static bool isOnSegment(const double &ax, const double &ay, const double &bx, const double &by, const double &px,
+                          const double &py);
+
+  /**
+   *  Distance between the state and the segment
+   */
+  static double calcDistance(const Edge &edge, const State &state);
+
+  /**
+   *  Distance between two segments (zero if they intersect)
+   */
+  static double calcDistance(const Edge &edge, const State &src, const State &dst);
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_POLYGONCONSTRAINT_POLYGONCONSTRAINT_H_ */
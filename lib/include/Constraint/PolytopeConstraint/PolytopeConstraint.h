@@ -0,0 +1,162 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_POLYTOPECONSTRAINT_POLYTOPECONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_POLYTOPECONSTRAINT_POLYTOPECONSTRAINT_H_
+
+#include <BVH/BVH.h>
+#include <Constraint/ConstraintBase.h>
+#include <State/State.h>
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::ConstraintBase
+ *  This class express constraint as set of axis-aligned box and convex polytope
+ *  and obstacles are indexed by BVH to cull obstacles far from the query
+ */
+class PolytopeConstraint : public base::ConstraintBase {
+ public:
+  /**
+   *  Axis-aligned box as a way of expressing of Obstacle
+   */
+  class Box {
+   public:
+    /**
+     *  Constructor(Box)
+     *  @low:  lower corner of box
+     *  @high: upper corner of box
+     *         (if 'high' is less than 'low' at any dimension, throw std::invalid_argument)
+     */
+    Box(const State &low, const State &high);
+
+    const State &getLow() const;
+    const State &getHigh() const;
+
+   private:
+    State low_;
+    State high_;
+  };
+
+  /**
+   *  Convex polytope '{x | Ax <= b}' as a way of expressing of Obstacle
+   */
+  class Polytope {
+   public:
+    /**
+     *  Constructor(Polytope)
+     *  @A: normal of each half-space (each row correspond with a half-space)
+     *  @b: offset of each half-space
+     */
+    Polytope(const Eigen::MatrixXd &A, const Eigen::VectorXd &b);
+
+    const Eigen::MatrixXd &getA() const;
+    const Eigen::VectorXd &getB() const;
+
+   private:
+    Eigen::MatrixXd A_;
+    Eigen::VectorXd b_;
+  };
+
+  /**
+   *  Constructor(PolytopeConstraint)
+   *  @space: target space
+   */
+  explicit PolytopeConstraint(const EuclideanSpace &space);
+
+  /**
+   *  Constructor(PolytopeConstraint)
+   *  @space:     target space
+   *  @boxes:     set of box
+   *  @polytopes: set of convex polytope
+   *              if dimension of obstacle different from dimension of space,
+   *              this constructor throw std::invalid_argument
+   */
+  PolytopeConstraint(const EuclideanSpace &space, const std::vector<Box> &boxes,
+                     const std::vector<Polytope> &polytopes);
+
+  ~PolytopeConstraint() override;
+
+  void set(const std::vector<Box> &boxes, const std::vector<Polytope> &polytopes);
+
+  const std::vector<Box> &getBoxesRef() const;
+
+  const std::vector<Polytope> &getPolytopesRef() const;
+
+  bool checkCollision(const State &src, const State &dst) const override;
+
+  ConstraintType checkConstraintType(const State &state) const override;
+
+ private:
+  std::vector<Box> boxes_;
+  std::vector<Polytope> polytopes_;
+
+  // primitive 'i' of BVH is boxes_[i] if 'i' is less than the number of boxes,
+  // otherwise polytopes_[i - boxes_.size()]
+  BVH bvh_;
+
+  /**
+   *  Calculate bounding box of polytope clipped by the bound of space
+   *  by minimizing and maximizing each coordinate with the simplex method
+   *  @polytope: target polytope
+   *  @low:      lower corner of bounding box (empty box if polytope is empty)
+   *  @high:     upper corner of bounding box
+   */
+  void calcPolytopeBound(const Polytope &polytope, double *low, double *high) const;
+
+  /**
+   *  Maximize the objective from the basic feasible solution of the tableau
+   *  @tableau:           constraints in canonical form for 'basis' (the last column is right hand side)
+   *  @basis:             basic variable of each row
+   *  @objective:         coefficient of each variable (variables out of its size have zero coefficient)
+   *  @num_entering_cols: only the variables of the first columns can enter the basis
+   *  @Return:            maximum value of the objective
+   */
+  static double runSimplex(Eigen::MatrixXd &tableau, std::vector<int> &basis, const Eigen::VectorXd &objective,
+                           const int &num_entering_cols);
+
+  /**
+   *  Pivot the tableau so that the variable of 'col' becomes basic variable of 'row'
+   */
+  static void pivotTableau(Eigen::MatrixXd &tableau, std::vector<int> &basis, const int &row, const int &col);
+
+  /**
+   *  Check whether the segment intersects the box by slab test
+   *  @Return: If the segment intersects the box (including its boundary), return true
+   */
+  bool intersectBox(const Box &box, const State &src, const State &dst) const;
+
+  /**
+   *  Check whether the segment intersects the polytope by clipping the segment with each half-space
+   *  @src_dir: source state and direction of the segment as columns
+   *  @Return:  If the segment intersects the polytope (including its boundary), return true
+   */
+  bool intersectPolytope(const Polytope &polytope, const Eigen::Matrix<double, Eigen::Dynamic, 2> &src_dir) const;
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_POLYTOPECONSTRAINT_POLYTOPECONSTRAINT_H_ */
@@ -0,0 +1,111 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_CONSTRAINT_VOXELCONSTRAINT_VOXELCONSTRAINT_H_
+#define LIB_INCLUDE_CONSTRAINT_VOXELCONSTRAINT_VOXELCONSTRAINT_H_
+
+#include <Constraint/ConstraintBase.h>
+#include <State/State.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Super class of planner::ConstraintBase
+ *  This class express constraint as occupancy of voxels in 3 dimensional space
+ *  Voxels are packed into bricks of 4x4x4 voxels so that a brick is a 64 bit word,
+ *  and a segment is traversed by 3D DDA which jumps over empty bricks at once
+ */
+class VoxelConstraint : public base::ConstraintBase {
+ public:
+  /**
+   *  Constructor(VoxelConstraint)
+   *  All voxels are initialized to be free
+   *  @space:      target space (if dimension of space is not 3, throw std::invalid_argument)
+   *  @voxel_size: edge length of a voxel
+   */
+  VoxelConstraint(const EuclideanSpace &space, const double &voxel_size);
+
+  ~VoxelConstraint() override;
+
+  /**
+   *  Make all voxels free
+   */
+  void clear();
+
+  /**
+   *  Set occupancy of the voxel which contains the state
+   *  (if the state is out of space, throw std::invalid_argument)
+   */
+  void setOccupied(const State &state, const bool &occupied = true);
+
+  /**
+   *  Set occupancy of the voxel
+   *  (if the index is out of range, throw std::invalid_argument)
+   */
+  void setOccupied(const uint32_t &x, const uint32_t &y, const uint32_t &z, const bool &occupied = true);
+
+  bool isOccupied(const uint32_t &x, const uint32_t &y, const uint32_t &z) const;
+
+  double getVoxelSize() const;
+
+  /**
+   *  Number of voxels on each axis
+   */
+  const std::array<uint32_t, 3> &getSizeRef() const;
+
+  bool checkCollision(const State &src, const State &dst) const override;
+
+  ConstraintType checkConstraintType(const State &state) const override;
+
+ private:
+  static constexpr uint32_t BRICK_BITS = 2;
+  static constexpr uint32_t BRICK_MASK = (1u << BRICK_BITS) - 1;
+
+  const double voxel_size_;
+  std::array<uint32_t, 3> size_;
+  std::array<uint32_t, 3> brick_size_;
+  std::array<double, 3> low_;
+
+  // occupancy of voxels (bit 'x + 4 * y + 16 * z' of a brick is the voxel at local index (x, y, z))
+  std::vector<uint64_t> bricks_;
+
+  /**
+   *  Index of the voxel which contains the state
+   *  (a state on the upper bound of space belongs to the last voxel)
+   *  @Return: false if the state is out of space
+   */
+  bool calcVoxelIdx(const State &state, std::array<int32_t, 3> &idx) const;
+
+  size_t calcBrickIdx(const std::array<int32_t, 3> &idx) const;
+
+  static uint64_t calcBitMask(const std::array<int32_t, 3> &idx);
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_CONSTRAINT_VOXELCONSTRAINT_VOXELCONSTRAINT_H_ */
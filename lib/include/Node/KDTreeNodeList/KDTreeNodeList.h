@@ -44,9 +44,10 @@ class KDTreeNodeList : public base::NodeListBase {
   NodePtr searchNN(const NodePtr &node);
   std::vector<NodePtr> searchNBHD(const NodePtr &node, const double &radius);
   std::vector<NodePtr> searchLeafs();
+  std::vector<NodePtr> remove(const std::function<bool(const NodePtr &)> &is_removed);
 
  private:
-  const double REBALANCE_RATIO = 0.1;
+  static constexpr double REBALANCE_RATIO = 0.1;
 
   struct KDTreeNode {
     int idx;
@@ -62,6 +63,11 @@ class KDTreeNodeList : public base::NodeListBase {
   std::vector<NodePtr> nodes_;
   int depth_;
 
+  /**
+   *  Rebuild balanced kd-tree of all nodes
+   */
+  void rebuild();
+
   void clearRec(const KDNodePtr &node);
 
   KDNodePtr buildRec(std::vector<int> &indices, const int &offset, const int &npoints, const int &depth);
@@ -29,6 +29,7 @@
 
 #include <limits>
 #include <memory>
+#include <vector>
 
 namespace planner {
 class Node {
@@ -39,6 +40,21 @@ class Node {
   double cost_to_goal;
   bool is_leaf;
 
+  // nodes whose parent is this node (linked when they are added to node list)
+  std::vector<std::weak_ptr<Node>> children;
+
+  // false while the edge from parent has not been checked yet (lazy collision checking)
+  bool is_edge_checked;
+
+  // true if the state is known to meet constraint (so that it is not checked again)
+  bool is_valid;
+
+  // clearance of state (negative if it has not been calculated yet)
+  double clearance;
+
+  // identifier assigned by planner (max value of uint32_t if not assigned)
+  uint32_t id;
+
   Node(const State &_state, const std::shared_ptr<Node> _parent, const double &_cost = 0.0,
        const double &_cost_to_goal = std::numeric_limits<double>::max());
   ~Node();
@@ -27,6 +27,9 @@
 
 #include <Node/Node.h>
 
+#include <functional>
+#include <vector>
+
 namespace planner {
 namespace base {
 /**
@@ -45,6 +48,13 @@ class NodeListBase {
   virtual NodePtr searchNN(const NodePtr &node) = 0;
   virtual std::vector<NodePtr> searchNBHD(const NodePtr &node, const double &radius) = 0;
   virtual std::vector<NodePtr> searchLeafs() = 0;
+
+  /**
+   *  Remove nodes which satisfy the condition
+   *  @is_removed: condition of nodes to remove
+   *  @Return:     removed nodes
+   */
+  virtual std::vector<NodePtr> remove(const std::function<bool(const NodePtr &)> &is_removed) = 0;
 };
 }  // namespace base
 }  // namespace planner
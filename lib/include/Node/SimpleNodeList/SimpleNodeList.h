@@ -45,6 +45,7 @@ class SimpleNodeList : public base::NodeListBase {
   NodePtr searchNN(const NodePtr &node);
   std::vector<NodePtr> searchNBHD(const NodePtr &node, const double &radius);
   std::vector<NodePtr> searchLeafs();
+  std::vector<NodePtr> remove(const std::function<bool(const NodePtr &)> &is_removed);
 
  private:
   std::vector<NodePtr> list_;
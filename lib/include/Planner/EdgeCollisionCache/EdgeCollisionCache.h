@@ -0,0 +1,92 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_PLANNER_EDGECOLLISIONCACHE_EDGECOLLISIONCACHE_H_
+#define LIB_INCLUDE_PLANNER_EDGECOLLISIONCACHE_EDGECOLLISIONCACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace planner {
+/**
+ *  Cache of results of collision check between two nodes
+ *  This class is open addressing hash set whose entry packs
+ *  the pair of node ids (31 bits each) and the result into 64 bits
+ */
+class EdgeCollisionCache {
+ public:
+  explicit EdgeCollisionCache(const size_t &initial_capacity = 1024);
+  ~EdgeCollisionCache();
+
+  /**
+   *  Remove all entries and reset hit statistics
+   */
+  void clear();
+
+  /**
+   *  Find result of the edge between two nodes (the order of ids does not matter)
+   *  @id1:     id of a node
+   *  @id2:     id of another node
+   *  @is_free: result of collision check if found
+   *  @Return:  whether the result was found
+   */
+  bool find(const uint32_t &id1, const uint32_t &id2, bool &is_free);
+
+  /**
+   *  Store result of the edge between two nodes
+   *  (ignored if either id is out of 31 bits)
+   */
+  void insert(const uint32_t &id1, const uint32_t &id2, const bool &is_free);
+
+  size_t getSize() const;
+
+  uint64_t getNumHits() const;
+
+  uint64_t getNumMisses() const;
+
+  double getHitRate() const;
+
+ private:
+  static constexpr uint64_t EMPTY = std::numeric_limits<uint64_t>::max();
+  static constexpr uint32_t MAX_ID = (1u << 31) - 1;
+
+  // table is extended when the load factor exceeds this value
+  const double MAX_LOAD_FACTOR = 0.5;
+
+  std::vector<uint64_t> table_;
+  size_t size_;
+  uint64_t num_hits_;
+  uint64_t num_misses_;
+
+  static uint64_t calcKey(const uint32_t &id1, const uint32_t &id2);
+
+  static uint64_t calcHash(uint64_t key);
+
+  void rehash(const size_t &capacity);
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_PLANNER_EDGECOLLISIONCACHE_EDGECOLLISIONCACHE_H_ */
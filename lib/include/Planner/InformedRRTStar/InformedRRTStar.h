@@ -32,6 +32,7 @@
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -48,6 +49,13 @@ class InformedRRTStar : public base::PlannerBase {
   void setR(const double &R);
   void setGoalRegionRadius(const double &goal_region_radius);
 
+  /**
+   *  Nodes whose lower bound of the path cost (cost from start + distance to goal) exceeds the best cost are pruned
+   *  every time the best cost decreases by this ratio (0.05 by default, and 1 or more disables pruning)
+   *  @prune_threshold: ratio of decrease of the best cost since the last pruning
+   */
+  void setPruneThreshold(const double &prune_threshold);
+
   bool solve(const State &start, const State &goal) override;
 
  private:
@@ -56,6 +64,7 @@ class InformedRRTStar : public base::PlannerBase {
   double expand_dist_;
   double R_;
   double goal_region_radius_;
+  double prune_threshold_;
 };
 }  // namespace planner
 
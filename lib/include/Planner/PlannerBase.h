@@ -27,7 +27,13 @@
 
 #include <Constraint/ConstraintBase.h>
 #include <Node/NodeListBase.h>
+#include <Planner/EdgeCollisionCache/EdgeCollisionCache.h>
+#include <Planner/PlannerStatistics/PlannerStatistics.h>
 #include <Sampler/Sampler.h>
+#include <ThreadPool/ThreadPool.h>
+
+#include <chrono>
+#include <functional>
 
 namespace planner {
 namespace base {
@@ -36,6 +42,9 @@ namespace base {
  */
 class PlannerBase {
  public:
+  using Clock = std::chrono::steady_clock;
+  using ImprovementCallback = std::function<void(const std::vector<State> &path, const double &cost)>;
+
   explicit PlannerBase(const uint32_t &dim, std::shared_ptr<NodeListBase> node_list);
   virtual ~PlannerBase();
 
@@ -56,19 +65,162 @@ class PlannerBase {
 
   void setTerminateSearchCost(const double &terminate_search_cost);
 
+  /**
+   *  Enable or disable caching results of collision check between nodes
+   *  (disabled by default, the cache is cleared at the beginning of solve())
+   */
+  void setUseCollisionCache(const bool &use_collision_cache);
+
+  /**
+   *  Cache of collision check used in last solve() (it also reports hit rate)
+   */
+  const EdgeCollisionCache &getCollisionCache() const;
+
+  /**
+   *  Enable or disable skipping collision check of edges which are shorter than clearance of either end
+   *  (enabled by default, clearance is calculated once for each node by ConstraintBase::clearance())
+   */
+  void setUseClearance(const bool &use_clearance);
+
+  /**
+   *  Number of threads which check collision of near nodes in updateParent() and rewireNearNodes()
+   *  (1 by default, and constraint must be safe for concurrent calls of its const functions when it is more than 1)
+   *  @num_threads: number of threads including the calling thread (0 means the number of hardware threads)
+   */
+  void setNumThreads(const uint32_t &num_threads);
+
+  /**
+   *  Share a thread pool with other planners instead of setNumThreads()
+   *  @thread_pool: thread pool (nullptr means single thread)
+   */
+  void setThreadPool(const std::shared_ptr<ThreadPool> &thread_pool);
+
+  uint32_t getNumThreads() const;
+
+  /**
+   *  Stop solve() when the time budget has elapsed since solve() was called, and return the best path found so far
+   *  (the clock is checked every 'check_interval' iterations, or at the shorter interval of this and
+   *   setDeadline() if both are set)
+   *  @time_budget:    time budget of each solve() (Clock::duration::max() means no budget)
+   *  @check_interval: number of iterations between checks of the clock
+   */
+  void setTimeBudget(const Clock::duration &time_budget, const uint32_t &check_interval = 16);
+
+  /**
+   *  Stop solve() at the deadline, and return the best path found so far
+   *  (the clock is checked every 'check_interval' iterations, or at the shorter interval of this and
+   *   setTimeBudget() if both are set)
+   *  @deadline:       deadline of solve() (Clock::time_point::max() means no deadline)
+   *  @check_interval: number of iterations between checks of the clock
+   */
+  void setDeadline(const Clock::time_point &deadline, const uint32_t &check_interval = 16);
+
+  /**
+   *  Function called in solve() every time the cost of the best path decreases
+   *  (the path is also available by getResult() and getResultView() in the function)
+   *  @callback: function which receives the path from start state to goal state and its cost
+   */
+  void setImprovementCallback(const ImprovementCallback &callback);
+
+  /**
+   *  Counters of last solve()
+   */
+  const PlannerStatistics &getStatistics() const;
+
+  /**
+   *  Path of last solve() from start state to goal state
+   *  (states are copied from the tree at the first call after solve())
+   */
   const std::vector<State> &getResult() const;
 
+  /**
+   *  Path of last solve() as pointers to states in the tree without copying them
+   *  (valid until the next solve())
+   */
+  const std::vector<const State *> &getResultView() const;
+
   double getResultCost() const;
 
   std::shared_ptr<NodeListBase> getNodeList() const;
 
  protected:
-  std::vector<State> result_;
   double result_cost_;
   double terminate_search_cost_;
   std::shared_ptr<ConstraintBase> constraint_;
   std::shared_ptr<NodeListBase> node_list_;
   std::unique_ptr<Sampler> sampler_;
+  PlannerStatistics statistics_;
+
+  /**
+   *  Initialize node list, collision cache, statistics and result, and add start node to node list
+   *  @start:  start state
+   *  @Return: start node
+   */
+  std::shared_ptr<Node> initPlanning(const State &start);
+
+  /**
+   *  Whether the deadline or the time budget of solve() has passed
+   *  (this function is supposed to be called once per iteration, and the clock is checked every check interval)
+   */
+  bool isTimeOver();
+
+  /**
+   *  Store the path to the node as result and call improvement callback if it is set
+   *  @node: terminal node of the path
+   *  @goal: goal state
+   *  @cost: cost of the path which is less than the best cost so far
+   */
+  void notifyImprovement(const std::shared_ptr<Node> &node, const State &goal, const double &cost);
+
+  /**
+   *  Store the path from start node to the node as result
+   *  @node: terminal node of the path
+   *  @goal: goal state which is appended if it is not the state of the node
+   */
+  void storeResult(const std::shared_ptr<Node> &node, const State &goal);
+
+  /**
+   *  Create node which has unique id in current planning
+   *  @state:  state of node
+   *  @parent: parent node
+   *  @cost:   cost from start node
+   *  @Return: created node
+   */
+  std::shared_ptr<Node> createNode(const State &state, const std::shared_ptr<Node> &parent, const double &cost = 0.0);
+
+  /**
+   *  Check collision of the edge between two nodes via collision cache
+   *  @src:    source node
+   *  @dst:    destination node
+   *  @Return: whether the edge meets constraint
+   */
+  bool checkCollision(const std::shared_ptr<Node> &src, const std::shared_ptr<Node> &dst);
+
+  /**
+   *  Whether a path through the state can be cheaper than the best cost
+   *  (the distance from start plus the distance to goal is a lower bound because edge cost is not less than distance)
+   */
+  static bool canImprove(const State &start, const State &goal, const State &state, const double &best_cost);
+
+  /**
+   *  Clearance of the node (calculated at the first call)
+   */
+  double getClearance(const std::shared_ptr<Node> &node) const;
+
+  /**
+   *  Whether the edge is free because it is shorter than clearance of either end
+   */
+  bool isInClearance(const std::shared_ptr<Node> &src, const std::shared_ptr<Node> &dst) const;
+
+  /**
+   *  Check collision of edges from a node via collision cache
+   *  (edges which are not in the cache are checked by ConstraintBase::checkCollisionBatch())
+   *  @src:     source node
+   *  @dsts:    destination nodes
+   *  @results: whether each edge meets constraint
+   */
+  void checkCollisionBatch(const std::shared_ptr<Node> &src, const std::vector<std::shared_ptr<Node>> &dsts,
+                           std::vector<bool> &results);
 
   /**
    *  Generate Steered node that is 'expand_dist' away from 'src_node' to
@@ -79,26 +231,81 @@ class PlannerBase {
    *  @Return:      steered node
    */
   std::shared_ptr<Node> generateSteerNode(const std::shared_ptr<Node> &src_node, const std::shared_ptr<Node> &dst_node,
-                                          const double &expand_dist) const;
+                                          const double &expand_dist);
+
+  /**
+   *  Change parent of the node in the tree and propagate the change of cost to its descendants
+   *  (costs of descendants are shifted by the difference, and a descendant whose cost is unknown is not changed
+   *   with its subtree, or all of them are recalculated if the previous cost of the node is unknown)
+   *  @node:          node in node list
+   *  @parent:        new parent node
+   *  @cost:          new cost of the node
+   *  @changed_nodes: the node and its descendants are appended
+   */
+  void changeParent(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &parent, const double &cost,
+                    std::vector<std::shared_ptr<Node>> &changed_nodes);
+
+  /**
+   *  Remove nodes and their descendants from node list and unlink them from the tree
+   *  @is_removed: condition of nodes to remove
+   *  @Return:     number of removed nodes
+   */
+  size_t removeNodes(const std::function<bool(const std::shared_ptr<Node> &)> &is_removed);
 
   /**
    *  Choose parent node from near node that find in findNearNodes()
+   *  (candidates are checked in ascending order of cost until a valid one is found,
+   *   and the target node must not be added to node list yet)
    *  @target_node:       target node
    *  @node_list:         list that contein existing node
    *  @near_node_indexes: return value of findNearNodes()
+   *  @lazy:              if true, accept the lowest cost parent without collision check
+   *                      and mark the edge as unchecked
    *  @Return: node that choosed new parent node
    */
-  void updateParent(const std::shared_ptr<Node> &target_node,
-                    const std::vector<std::shared_ptr<Node>> &near_nodes) const;
+  void updateParent(const std::shared_ptr<Node> &target_node, const std::vector<std::shared_ptr<Node>> &near_nodes,
+                    const bool &lazy = false);
 
   /**
    *  redefine parent node of near node that find in findNearNodes()
+   *  (near nodes which cannot become cheaper through 'new_node' are not checked)
    *  @node_list:         list that contein existing node
    *  @near_node_indexes: return value of findNearNodes()
-   *  @Return:            nodes which are rewired
+   *  @lazy:              if true, rewire without collision check and mark the edges as unchecked
+   *  @Return:            nodes whose cost is changed (rewired nodes and their descendants)
    */
   std::vector<std::shared_ptr<Node>> rewireNearNodes(std::shared_ptr<Node> &new_node,
-                                                     std::vector<std::shared_ptr<Node>> &near_nodes) const;
+                                                     std::vector<std::shared_ptr<Node>> &near_nodes,
+                                                     const bool &lazy = false);
+
+ private:
+  // edges checked in parallel are divided into this number of chunks per thread for load balancing
+  static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+  // result is copied from result_view_ when getResult() is called
+  mutable std::vector<State> result_;
+  std::vector<const State *> result_view_;
+  State result_goal_;
+
+  bool use_clearance_;
+  bool use_collision_cache_;
+  EdgeCollisionCache collision_cache_;
+  uint32_t next_node_id_;
+  std::shared_ptr<ThreadPool> thread_pool_;
+
+  Clock::duration time_budget_;
+  Clock::time_point deadline_;
+  uint32_t time_budget_check_interval_;
+  uint32_t deadline_check_interval_;
+  uint32_t time_check_interval_;
+  uint32_t time_check_count_;
+  Clock::time_point solve_deadline_;
+  ImprovementCallback improvement_callback_;
+
+  /**
+   *  Remove the node from children of its parent (parent of the node is not changed)
+   */
+  static void unlinkFromParent(const std::shared_ptr<Node> &node);
 };
 }  // namespace base
 }  // namespace planner
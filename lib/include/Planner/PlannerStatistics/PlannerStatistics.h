@@ -0,0 +1,65 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_PLANNER_PLANNERSTATISTICS_PLANNERSTATISTICS_H_
+#define LIB_INCLUDE_PLANNER_PLANNERSTATISTICS_PLANNERSTATISTICS_H_
+
+#include <cstdint>
+#include <iostream>
+
+namespace planner {
+/**
+ *  Counters of work done in a planning (reset at the beginning of solve())
+ */
+struct PlannerStatistics {
+  // near nodes which are examined as parent or child of new nodes
+  uint64_t num_near_nodes;
+
+  // near nodes which are skipped without collision check because they cannot improve the cost
+  uint64_t num_skipped_candidates;
+
+  // edges which are accepted without collision check because they are shorter than clearance
+  uint64_t num_clearance_skips;
+
+  // edges which are checked by constraint (edges found in collision cache are not included)
+  uint64_t num_collision_checks;
+
+  // nodes which are removed from the tree because they cannot improve the best path
+  uint64_t num_pruned_nodes;
+
+  // samples which are rejected before searching node list because they cannot improve the best path
+  uint64_t num_rejected_samples;
+
+  // new nodes which are rejected before collision check because they cannot improve the best path
+  uint64_t num_rejected_nodes;
+
+  PlannerStatistics();
+
+  void reset();
+
+  friend std::ostream &operator<<(std::ostream &os, const PlannerStatistics &obj);
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_PLANNER_PLANNERSTATISTICS_PLANNERSTATISTICS_H_ */
@@ -28,11 +28,14 @@
 #include <Node/KDTreeNodeList/KDTreeNodeList.h>
 #include <Planner/PlannerBase.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <queue>
 #include <random>
+#include <unordered_map>
 #include <vector>
 
 namespace planner {
@@ -47,13 +50,83 @@ class RRTStar : public base::PlannerBase {
   void setExpandDist(const double &expand_dist);
   void setR(const double &R);
 
+  /**
+   *  Enable or disable lazy collision checking
+   *  In lazy mode, edges chosen by updateParent() and rewireNearNodes() are accepted without collision check,
+   *  and they are checked only when they become part of a candidate solution
+   *  (an invalid edge is repaired by reconnecting the node to another near node)
+   */
+  void setLazyCollisionCheck(const bool &lazy_collision_check);
+
   bool solve(const State &start, const State &goal) override;
 
  private:
+  /**
+   *  Node which connects to goal and the cost of the path through it when it was pushed
+   */
+  struct GoalCandidate {
+    double cost;
+    double edge_cost;
+    std::shared_ptr<Node> node;
+
+    bool operator>(const GoalCandidate &other) const { return cost > other.cost; }
+  };
+
   uint32_t max_sampling_num_;
   double goal_sampling_rate_;
   double expand_dist_;
   double R_;
+  bool lazy_collision_check_;
+
+  // whether repairing has failed since unreachable nodes were removed last time
+  bool has_unreachable_nodes_;
+
+  // min-heap of nodes which connect to goal
+  // (an entry is stale if the cost of its node has changed, and it is replaced when it reaches the top)
+  std::priority_queue<GoalCandidate, std::vector<GoalCandidate>, std::greater<GoalCandidate>> goal_candidates_;
+
+  // edge cost to goal of each node which is checked (negative if the edge does not meet constraint)
+  std::unordered_map<uint32_t, double> goal_edge_costs_;
+
+  /**
+   *  Push the node to goal candidates if it is close to goal and the edge to goal meets constraint
+   *  (the edge is checked only once for each node)
+   *  @node:      node whose cost is new or changed
+   *  @goal_node: node of goal state
+   */
+  void pushGoalCandidate(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &goal_node);
+
+  /**
+   *  Node of the lowest cost path to goal (the path is validated in lazy collision checking)
+   *  @goal_node: node of goal state
+   *  @Return:    nullptr if there is no path to goal
+   */
+  std::shared_ptr<Node> getBestGoalCandidate(const std::shared_ptr<Node> &goal_node);
+
+  /**
+   *  Radius of neighborhood for current size of node list
+   */
+  double calcNearRadius() const;
+
+  /**
+   *  Check unchecked edges on the path from start node to 'node' and repair invalid edges
+   *  Costs of nodes on the path are updated to the actual cost
+   *  @node:      terminal node of the path
+   *  @goal_node: node of goal state
+   *  @Return:    whether the path is collision free after repairing
+   */
+  bool validatePath(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &goal_node);
+
+  /**
+   *  Reconnect the node to the lowest cost near node which is not a descendant of the node
+   *  If no valid parent exists, costs of the node and its descendants become infinite
+   *  so that they are never chosen as parent, and they are removed from node list in solve()
+   *  Nodes whose cost is changed by reconnecting are pushed to goal candidates
+   *  @node:      node whose edge from parent is invalid
+   *  @goal_node: node of goal state
+   *  @Return:    whether the node was reconnected
+   */
+  bool repairParent(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &goal_node);
 };
 }  // namespace planner
 
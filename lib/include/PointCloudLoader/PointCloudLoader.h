@@ -0,0 +1,117 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_POINTCLOUDLOADER_POINTCLOUDLOADER_H_
+#define LIB_INCLUDE_POINTCLOUDLOADER_POINTCLOUDLOADER_H_
+
+#include <Constraint/PointCloudConstraint/PointCloudConstraint.h>
+#include <EuclideanSpace/EuclideanSpace.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace planner {
+/**
+ *  Load point cloud with voxel downsampling and generate PointCloudConstraint
+ *  Points are streamed in fixed size chunks and only occupied voxels are kept,
+ *  so that memory usage does not depend on the number of input points
+ */
+class PointCloudLoader {
+ public:
+  /**
+   *  Constructor(PointCloudLoader)
+   *  @space:      target space (points out of the bounds are ignored)
+   *  @voxel_size: edge length of a voxel
+   */
+  PointCloudLoader(const EuclideanSpace &space, const double &voxel_size);
+  ~PointCloudLoader();
+
+  void clear();
+
+  /**
+   *  Add points from raw buffer
+   *  @data:       buffer of points
+   *  @num_points: number of points
+   *  @stride:     number of values per point (first 'dim' values are used)
+   */
+  void addPoints(const float *data, const size_t &num_points, const uint32_t &stride);
+
+  /**
+   *  Add points from PCD file (DATA ascii or binary)
+   *  Fields 'x', 'y' and 'z' are used as far as the dimension of space
+   */
+  void loadPCD(const std::string &file_path);
+
+  /**
+   *  Add points from PLY file (ascii or binary_little_endian)
+   *  Properties 'x', 'y' and 'z' of element 'vertex' are used as far as the dimension of space
+   */
+  void loadPLY(const std::string &file_path);
+
+  size_t getNumVoxels() const;
+
+  /**
+   *  Set one hypersphere per occupied voxel to the constraint
+   *  (radius of hypersphere is a half of the diagonal of the voxel)
+   *  @constraint: target constraint
+   */
+  void apply(PointCloudConstraint &constraint) const;
+
+  std::shared_ptr<PointCloudConstraint> generateConstraint() const;
+
+ private:
+  // number of points read from file at once
+  static constexpr size_t CHUNK_POINTS = 4096;
+
+  enum class ScalarType { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+  struct Field {
+    size_t offset;
+    ScalarType type;
+  };
+
+  const EuclideanSpace space_;
+  const double voxel_size_;
+  std::vector<uint64_t> each_dim_num_;
+  std::unordered_set<uint64_t> voxels_;
+
+  void addPoint(const double *point);
+
+  void readBinary(std::ifstream &ifs, const uint64_t &num_points, const size_t &point_step,
+                  const std::vector<Field> &fields);
+
+  void readAscii(std::ifstream &ifs, const uint64_t &num_points, const size_t &num_values,
+                 const std::vector<size_t> &columns);
+
+  static size_t getScalarSize(const ScalarType &type);
+
+  static double readScalar(const char *ptr, const ScalarType &type);
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_POINTCLOUDLOADER_POINTCLOUDLOADER_H_ */
@@ -49,6 +49,11 @@ class State {
 
   ~State();
 
+  State(const State &) = default;
+  State(State &&) noexcept = default;
+  State &operator=(const State &) = default;
+  State &operator=(State &&) noexcept = default;
+
   uint32_t getDim() const;
 
   double norm() const;
@@ -0,0 +1,95 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef LIB_INCLUDE_THREADPOOL_THREADPOOL_H_
+#define LIB_INCLUDE_THREADPOOL_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace planner {
+
+/**
+ *  Fixed number of threads which run a loop in parallel
+ *  The thread which calls parallelFor() also runs the loop, so that 'num_threads - 1' worker threads are created
+ *  A thread pool can be shared by planners, and calls of parallelFor() from several threads are serialized
+ */
+class ThreadPool {
+ public:
+  /**
+   *  Constructor(ThreadPool)
+   *  @num_threads: number of threads including the calling thread
+   *                (if it is zero, throw std::invalid_argument)
+   */
+  explicit ThreadPool(const uint32_t &num_threads);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  uint32_t getNumThreads() const;
+
+  /**
+   *  Call 'func' for each index in [0, num) in parallel and wait for all calls
+   *  (indices are distributed dynamically, and the first exception thrown by 'func' is rethrown)
+   *  @num:  number of indices
+   *  @func: function which is called with each index
+   */
+  void parallelFor(const size_t &num, const std::function<void(const size_t &)> &func);
+
+ private:
+  std::vector<std::thread> workers_;
+
+  // serializes calls of parallelFor()
+  std::mutex call_mutex_;
+
+  // state of the current loop (guarded by mutex_ except next_index_)
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(const size_t &)> *func_;
+  size_t num_;
+  std::atomic<size_t> next_index_;
+  uint32_t num_running_workers_;
+  uint64_t generation_;
+  bool is_terminated_;
+  std::exception_ptr exception_;
+
+  void work();
+
+  /**
+   *  Call func_ for indices which are not taken by other threads yet
+   */
+  void runLoop();
+};
+}  // namespace planner
+
+#endif /* LIB_INCLUDE_THREADPOOL_THREADPOOL_H_ */
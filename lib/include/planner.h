@@ -25,10 +25,19 @@
 #ifndef LIB_INCLUDE_PLANNER_H_
 #define LIB_INCLUDE_PLANNER_H_
 
+#include <Constraint/CompositeConstraint/CompositeConstraint.h>
+#include <Constraint/CostGridConstraint/CostGridConstraint.h>
 #include <Constraint/GridConstraint/GridConstraint.h>
+#include <Constraint/ManipulatorConstraint/ManipulatorConstraint.h>
+#include <Constraint/OctreeConstraint/OctreeConstraint.h>
 #include <Constraint/PointCloudConstraint/PointCloudConstraint.h>
+#include <Constraint/PolygonConstraint/PolygonConstraint.h>
+#include <Constraint/PolytopeConstraint/PolytopeConstraint.h>
+#include <Constraint/VoxelConstraint/VoxelConstraint.h>
 #include <Planner/InformedRRTStar/InformedRRTStar.h>
 #include <Planner/RRT/RRT.h>
 #include <Planner/RRTStar/RRTStar.h>
+#include <PointCloudLoader/PointCloudLoader.h>
+#include <ThreadPool/ThreadPool.h>
 
 #endif /* LIB_INCLUDE_PLANNER_H_ */
@@ -0,0 +1,337 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <BVH/BVH.h>
+
+namespace planner {
+BVH::BVH(const uint32_t &dim, const uint32_t &leaf_size) : dim_(dim), leaf_size_(std::max<uint32_t>(leaf_size, 1)) {}
+
+BVH::~BVH() {}
+
+void BVH::build(const std::vector<double> &lows, const std::vector<double> &highs) {
+  if (lows.size() != highs.size() || lows.size() % dim_ != 0) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of boxes is invalid");
+  }
+
+  clear();
+  const uint32_t npoints = lows.size() / dim_;
+  if (npoints == 0) {
+    return;
+  }
+
+  order_.resize(npoints);
+  std::iota(order_.begin(), order_.end(), 0);
+  nodes_.reserve(2 * (npoints / leaf_size_ + 1));
+  bounds_.reserve(2 * dim_ * nodes_.capacity());
+  buildRec(lows, highs, 0, npoints, -1);
+
+  prim_bounds_.resize(2 * dim_ * npoints);
+  prim_leaf_.resize(npoints);
+  for (uint32_t oi = 0; oi < npoints; oi++) {
+    std::copy(lows.begin() + order_[oi] * dim_, lows.begin() + (order_[oi] + 1) * dim_,
+              prim_bounds_.begin() + 2 * dim_ * oi);
+    std::copy(highs.begin() + order_[oi] * dim_, highs.begin() + (order_[oi] + 1) * dim_,
+              prim_bounds_.begin() + 2 * dim_ * oi + dim_);
+  }
+  for (size_t ni = 0; ni < nodes_.size(); ni++) {
+    if (nodes_[ni].left < 0) {
+      std::fill(prim_leaf_.begin() + nodes_[ni].begin, prim_leaf_.begin() + nodes_[ni].end, ni);
+    }
+  }
+}
+
+void BVH::clear() {
+  nodes_.clear();
+  bounds_.clear();
+  order_.clear();
+  prim_bounds_.clear();
+  prim_leaf_.clear();
+}
+
+uint32_t BVH::getDim() const { return dim_; }
+
+uint32_t BVH::getSize() const { return order_.size(); }
+
+const std::vector<uint32_t> &BVH::getOrderRef() const { return order_; }
+
+bool BVH::traverseSegment(const State &src, const State &dst, const LeafCallback &callback) const {
+  if (src.getDim() != dim_ || dst.getDim() != dim_) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  // the axis which the segment is parallel to has infinite inverse
+  std::vector<double> inv_dir(dim_);
+  for (size_t i = 0; i < dim_; i++) {
+    const auto dir = dst.vals[i] - src.vals[i];
+    inv_dir[i] = (dir == 0) ? std::numeric_limits<double>::infinity() : 1.0 / dir;
+  }
+
+  return traverse([&](const int32_t &node_idx) { return overlapSegment(node_idx, src, inv_dir); }, callback);
+}
+
+bool BVH::traversePoint(const State &state, const LeafCallback &callback) const {
+  if (state.getDim() != dim_) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  return traverse([&](const int32_t &node_idx) { return containPoint(node_idx, state); }, callback);
+}
+
+bool BVH::traverseBox(const State &low, const State &high, const LeafCallback &callback) const {
+  if (low.getDim() != dim_ || high.getDim() != dim_) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  return traverse([&](const int32_t &node_idx) { return overlapBox(node_idx, low, high); }, callback);
+}
+
+double BVH::traverseNearest(const State &state, const double &upper_bound, const DistanceCallback &callback) const {
+  if (state.getDim() != dim_) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  auto nearest = upper_bound;
+  if (nodes_.empty()) {
+    return nearest;
+  }
+
+  // nodes are compared by squared distance, and the nearer child is visited first
+  std::array<std::pair<int32_t, double>, MAX_STACK_SIZE> stack;
+  uint32_t stack_size = 0;
+  stack[stack_size++] = std::make_pair(0, calcSquaredDistance(0, state));
+  while (stack_size != 0) {
+    const auto item = stack[--stack_size];
+    if (nearest * nearest <= item.second) {
+      continue;
+    }
+
+    const auto &node = nodes_[item.first];
+    if (node.left < 0) {
+      nearest = std::min(nearest, callback(node.begin, node.end));
+    } else {
+      auto left = std::make_pair(node.left, calcSquaredDistance(node.left, state));
+      auto right = std::make_pair(node.right, calcSquaredDistance(node.right, state));
+      if (left.second < right.second) {
+        std::swap(left, right);
+      }
+      stack[stack_size++] = left;
+      stack[stack_size++] = right;
+    }
+  }
+
+  return nearest;
+}
+
+void BVH::refit(const uint32_t &order_idx, const std::vector<double> &low, const std::vector<double> &high) {
+  if (getSize() <= order_idx) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Index is out of range");
+  } else if (low.size() != dim_ || high.size() != dim_) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of box is invalid");
+  }
+
+  std::copy(low.begin(), low.end(), prim_bounds_.begin() + 2 * dim_ * order_idx);
+  std::copy(high.begin(), high.end(), prim_bounds_.begin() + 2 * dim_ * order_idx + dim_);
+
+  auto node_idx = prim_leaf_[order_idx];
+  fitLeaf(node_idx);
+  for (node_idx = nodes_[node_idx].parent; 0 <= node_idx; node_idx = nodes_[node_idx].parent) {
+    fitInternal(node_idx);
+  }
+}
+
+int32_t BVH::buildRec(const std::vector<double> &lows, const std::vector<double> &highs, const uint32_t &begin,
+                      const uint32_t &end, const int32_t &parent) {
+  const int32_t node_idx = nodes_.size();
+  nodes_.emplace_back();
+  nodes_[node_idx].parent = parent;
+  nodes_[node_idx].begin = begin;
+  nodes_[node_idx].end = end;
+
+  // bound of the node and extent of the centers of primitives
+  std::vector<double> low(dim_, std::numeric_limits<double>::max());
+  std::vector<double> high(dim_, std::numeric_limits<double>::lowest());
+  std::vector<double> center_low(dim_, std::numeric_limits<double>::max());
+  std::vector<double> center_high(dim_, std::numeric_limits<double>::lowest());
+  for (uint32_t i = begin; i < end; i++) {
+    const auto offset = order_[i] * dim_;
+    for (size_t di = 0; di < dim_; di++) {
+      low[di] = std::min(low[di], lows[offset + di]);
+      high[di] = std::max(high[di], highs[offset + di]);
+      const auto center = (lows[offset + di] + highs[offset + di]) / 2.0;
+      center_low[di] = std::min(center_low[di], center);
+      center_high[di] = std::max(center_high[di], center);
+    }
+  }
+  bounds_.insert(bounds_.end(), low.begin(), low.end());
+  bounds_.insert(bounds_.end(), high.begin(), high.end());
+
+  if (end - begin <= leaf_size_) {
+    return node_idx;
+  }
+
+  // split at the median along the axis which has the largest extent
+  size_t axis = 0;
+  for (size_t di = 1; di < dim_; di++) {
+    if (center_high[di] - center_low[di] > center_high[axis] - center_low[axis]) {
+      axis = di;
+    }
+  }
+
+  const uint32_t mid = begin + (end - begin) / 2;
+  auto comp = [&](const uint32_t &lhs, const uint32_t &rhs) {
+    return lows[lhs * dim_ + axis] + highs[lhs * dim_ + axis] < lows[rhs * dim_ + axis] + highs[rhs * dim_ + axis];
+  };
+  std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end, comp);
+
+  const auto left = buildRec(lows, highs, begin, mid, node_idx);
+  const auto right = buildRec(lows, highs, mid, end, node_idx);
+  nodes_[node_idx].left = left;
+  nodes_[node_idx].right = right;
+  return node_idx;
+}
+
+void BVH::fitLeaf(const int32_t &node_idx) {
+  double *low = &bounds_[2 * dim_ * node_idx];
+  double *high = low + dim_;
+  std::fill(low, high, std::numeric_limits<double>::max());
+  std::fill(high, high + dim_, std::numeric_limits<double>::lowest());
+  for (uint32_t oi = nodes_[node_idx].begin; oi < nodes_[node_idx].end; oi++) {
+    const double *prim_low = &prim_bounds_[2 * dim_ * oi];
+    const double *prim_high = prim_low + dim_;
+    for (size_t di = 0; di < dim_; di++) {
+      low[di] = std::min(low[di], prim_low[di]);
+      high[di] = std::max(high[di], prim_high[di]);
+    }
+  }
+}
+
+void BVH::fitInternal(const int32_t &node_idx) {
+  double *low = &bounds_[2 * dim_ * node_idx];
+  double *high = low + dim_;
+  const double *left_low = &bounds_[2 * dim_ * nodes_[node_idx].left];
+  const double *left_high = left_low + dim_;
+  const double *right_low = &bounds_[2 * dim_ * nodes_[node_idx].right];
+  const double *right_high = right_low + dim_;
+  for (size_t di = 0; di < dim_; di++) {
+    low[di] = std::min(left_low[di], right_low[di]);
+    high[di] = std::max(left_high[di], right_high[di]);
+  }
+}
+
+bool BVH::overlapSegment(const int32_t &node_idx, const State &src, const std::vector<double> &inv_dir) const {
+  const double *low = &bounds_[2 * dim_ * node_idx];
+  const double *high = low + dim_;
+
+  // slab test on the parameter of the segment (0 <= t <= 1)
+  double t_min = 0.0;
+  double t_max = 1.0;
+  for (size_t i = 0; i < dim_; i++) {
+    if (std::isinf(inv_dir[i])) {
+      if (src.vals[i] < low[i] || high[i] < src.vals[i]) {
+        return false;
+      }
+      continue;
+    }
+
+    // swap by the sign of direction so that an empty box (low > high) never overlaps
+    auto t_near = (low[i] - src.vals[i]) * inv_dir[i];
+    auto t_far = (high[i] - src.vals[i]) * inv_dir[i];
+    if (inv_dir[i] < 0) {
+      std::swap(t_near, t_far);
+    }
+
+    t_min = std::max(t_min, t_near);
+    t_max = std::min(t_max, t_far);
+    if (t_max < t_min) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool BVH::containPoint(const int32_t &node_idx, const State &state) const {
+  const double *low = &bounds_[2 * dim_ * node_idx];
+  const double *high = low + dim_;
+  for (size_t i = 0; i < dim_; i++) {
+    if (state.vals[i] < low[i] || high[i] < state.vals[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool BVH::overlapBox(const int32_t &node_idx, const State &low, const State &high) const {
+  const double *node_low = &bounds_[2 * dim_ * node_idx];
+  const double *node_high = node_low + dim_;
+  for (size_t i = 0; i < dim_; i++) {
+    if (high.vals[i] < node_low[i] || node_high[i] < low.vals[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+double BVH::calcSquaredDistance(const int32_t &node_idx, const State &state) const {
+  const double *low = &bounds_[2 * dim_ * node_idx];
+  const double *high = low + dim_;
+  double sq_dist = 0.0;
+  for (size_t i = 0; i < dim_; i++) {
+    const auto diff = std::max({low[i] - state.vals[i], state.vals[i] - high[i], 0.0});
+    sq_dist += diff * diff;
+  }
+
+  return sq_dist;
+}
+
+bool BVH::traverse(const std::function<bool(const int32_t &)> &is_overlapped, const LeafCallback &callback) const {
+  if (nodes_.empty()) {
+    return true;
+  }
+
+  std::array<int32_t, MAX_STACK_SIZE> stack;
+  uint32_t stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size != 0) {
+    const auto node_idx = stack[--stack_size];
+    if (!is_overlapped(node_idx)) {
+      continue;
+    }
+
+    const auto &node = nodes_[node_idx];
+    if (node.left < 0) {
+      if (!callback(node.begin, node.end)) {
+        return false;
+      }
+    } else {
+      stack[stack_size++] = node.right;
+      stack[stack_size++] = node.left;
+    }
+  }
+
+  return true;
+}
+}  // namespace planner
@@ -0,0 +1,238 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/CompositeConstraint/CompositeConstraint.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace planner {
+CompositeConstraint::CompositeConstraint(const EuclideanSpace &space) : base::ConstraintBase(space) {
+  set(std::vector<ConstraintPtr>());
+}
+
+CompositeConstraint::CompositeConstraint(const EuclideanSpace &space, const std::vector<ConstraintPtr> &constraints)
+    : base::ConstraintBase(space) {
+  set(constraints);
+}
+
+CompositeConstraint::~CompositeConstraint() {}
+
+void CompositeConstraint::set(const std::vector<ConstraintPtr> &constraints) {
+  for (const auto &constraint : constraints) {
+    if (constraint == nullptr || constraint->getDim() != getDim()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Constraint is invalid");
+    }
+  }
+
+  constraints_ = constraints;
+  resetStatistics();
+}
+
+void CompositeConstraint::add(const ConstraintPtr &constraint) {
+  auto constraints = constraints_;
+  constraints.push_back(constraint);
+  set(constraints);
+}
+
+const std::vector<CompositeConstraint::ConstraintPtr> &CompositeConstraint::getConstraintsRef() const {
+  return constraints_;
+}
+
+std::vector<size_t> CompositeConstraint::getOrder(const bool &for_collision) const {
+  return *std::atomic_load(&order_[for_collision ? COLLISION : CONSTRAINT_TYPE]);
+}
+
+void CompositeConstraint::resetStatistics() {
+  for (size_t type = 0; type < NUM_QUERY_TYPES; type++) {
+    stats_[type].reset(new Statistics[constraints_.size()]);
+    for (size_t i = 0; i < constraints_.size(); i++) {
+      stats_[type][i].num_rejects = 0;
+      stats_[type][i].elapsed_ns = 0;
+    }
+
+    auto order = std::make_shared<std::vector<size_t>>(constraints_.size());
+    std::iota(order->begin(), order->end(), 0);
+    std::atomic_store(&order_[type], std::shared_ptr<const std::vector<size_t>>(order));
+    num_queries_[type] = 0;
+  }
+}
+
+bool CompositeConstraint::checkCollision(const State &src, const State &dst) const {
+  if (base::ConstraintBase::checkConstraintType(src) == ConstraintType::NOENTRY ||
+      base::ConstraintBase::checkConstraintType(dst) == ConstraintType::NOENTRY) {
+    return false;
+  }
+
+  return evaluate(COLLISION,
+                  [&](const base::ConstraintBase &constraint) { return constraint.checkCollision(src, dst); });
+}
+
+bool CompositeConstraint::checkCollisionFromValidState(const State &src, const State &dst) const {
+  if (base::ConstraintBase::checkConstraintType(dst) == ConstraintType::NOENTRY) {
+    return false;
+  }
+
+  return evaluate(COLLISION, [&](const base::ConstraintBase &constraint) {
+    return constraint.checkCollisionFromValidState(src, dst);
+  });
+}
+
+void CompositeConstraint::checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                                              std::vector<bool> &results) const {
+  results.assign(dsts.size(), false);
+  if (base::ConstraintBase::checkConstraintType(src) == ConstraintType::NOENTRY) {
+    return;
+  }
+
+  // indices of edges which are not rejected yet
+  std::vector<size_t> pending;
+  pending.reserve(dsts.size());
+  for (size_t i = 0; i < dsts.size(); i++) {
+    if (base::ConstraintBase::checkConstraintType(dsts[i]) != ConstraintType::NOENTRY) {
+      pending.push_back(i);
+    }
+  }
+
+  const auto num_queries = num_queries_[COLLISION].fetch_add(pending.size());
+  if (num_queries / REORDER_INTERVAL != (num_queries + pending.size()) / REORDER_INTERVAL) {
+    reorder(COLLISION);
+  }
+
+  const auto order = std::atomic_load(&order_[COLLISION]);
+  std::vector<State> pending_dsts;
+  std::vector<bool> pending_results;
+  for (const auto &idx : *order) {
+    if (pending.empty()) {
+      return;
+    }
+    pending_dsts.clear();
+    for (const auto &i : pending) {
+      pending_dsts.push_back(dsts[i]);
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    constraints_[idx]->checkCollisionBatch(src, pending_dsts, pending_results);
+    const auto end_time = std::chrono::steady_clock::now();
+
+    size_t num_accepts = 0;
+    for (size_t j = 0; j < pending.size(); j++) {
+      if (pending_results[j]) {
+        pending[num_accepts++] = pending[j];
+      }
+    }
+
+    auto &stats = stats_[COLLISION][idx];
+    stats.elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    stats.num_rejects += pending.size() - num_accepts;
+    pending.resize(num_accepts);
+  }
+
+  for (const auto &i : pending) {
+    results[i] = true;
+  }
+}
+
+ConstraintType CompositeConstraint::checkConstraintType(const State &state) const {
+  if (base::ConstraintBase::checkConstraintType(state) == ConstraintType::NOENTRY) {
+    return ConstraintType::NOENTRY;
+  }
+
+  const auto is_free = evaluate(CONSTRAINT_TYPE, [&](const base::ConstraintBase &constraint) {
+    return constraint.checkConstraintType(state) == ConstraintType::ENTAERABLE;
+  });
+  return is_free ? ConstraintType::ENTAERABLE : ConstraintType::NOENTRY;
+}
+
+double CompositeConstraint::calcEdgeCost(const State &src, const State &dst) const {
+  auto cost = src.distanceFrom(dst);
+  for (const auto &constraint : constraints_) {
+    cost = std::max(cost, constraint->calcEdgeCost(src, dst));
+  }
+  return cost;
+}
+
+double CompositeConstraint::clearance(const State &state) const {
+  // distance to the boundary of space
+  auto nearest = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+    nearest = std::min({nearest, state.vals[i] - bound.low, bound.high - state.vals[i]});
+  }
+
+  for (const auto &constraint : constraints_) {
+    if (nearest <= 0.0) {
+      break;
+    }
+    nearest = std::min(nearest, constraint->clearance(state));
+  }
+  return std::max(nearest, 0.0);
+}
+
+bool CompositeConstraint::evaluate(const QueryType &type,
+                                   const std::function<bool(const base::ConstraintBase &)> &is_free) const {
+  if (++num_queries_[type] % REORDER_INTERVAL == 0) {
+    reorder(type);
+  }
+
+  const auto order = std::atomic_load(&order_[type]);
+  for (const auto &idx : *order) {
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto result = is_free(*constraints_[idx]);
+    const auto end_time = std::chrono::steady_clock::now();
+
+    auto &stats = stats_[type][idx];
+    stats.elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    if (!result) {
+      stats.num_rejects++;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CompositeConstraint::reorder(const QueryType &type) const {
+  // time per reject (a constraint which has never rejected is evaluated last)
+  std::vector<double> costs(constraints_.size());
+  for (size_t i = 0; i < constraints_.size(); i++) {
+    auto &stats = stats_[type][i];
+    const uint64_t num_rejects = stats.num_rejects;
+    const uint64_t elapsed_ns = stats.elapsed_ns;
+    costs[i] = (0 < num_rejects) ? (double)elapsed_ns / num_rejects : std::numeric_limits<double>::infinity();
+
+    // older queries decay by half at every reordering
+    stats.num_rejects -= num_rejects / 2;
+    stats.elapsed_ns -= elapsed_ns / 2;
+  }
+
+  auto order = std::make_shared<std::vector<size_t>>(constraints_.size());
+  std::iota(order->begin(), order->end(), 0);
+  std::stable_sort(order->begin(), order->end(), [&](const size_t &lhs, const size_t &rhs) {
+    return costs[lhs] < costs[rhs];
+  });
+  std::atomic_store(&order_[type], std::shared_ptr<const std::vector<size_t>>(order));
+}
+}  // namespace planner
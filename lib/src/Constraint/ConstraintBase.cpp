@@ -24,19 +24,49 @@
 
 #include <Constraint/ConstraintBase.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace planner {
 namespace base {
-ConstraintBase::ConstraintBase(const EuclideanSpace &_space) : space(_space) {}
+ConstraintBase::ConstraintBase(const EuclideanSpace &_space) : space(_space), resolution_(0.0) {}
 
 ConstraintBase::~ConstraintBase() {}
 
 uint32_t ConstraintBase::getDim() const { return space.getDim(); }
 
+void ConstraintBase::setResolution(const double &resolution) { resolution_ = resolution; }
+
+double ConstraintBase::getResolution() const {
+  if (0.0 < resolution_) {
+    return resolution_;
+  }
+
+  auto min_range = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < getDim(); i++) {
+    min_range = std::min(min_range, space.getBound(i + 1).getRange());
+  }
+  return 0.01 * min_range;
+}
+
 bool ConstraintBase::checkCollision(const State &src, const State &dst) const {
-  return (checkConstraintType(src) == ConstraintType::ENTAERABLE &&
-          checkConstraintType(dst) == ConstraintType::ENTAERABLE)
-             ? true
-             : false;
+  return checkConstraintType(src) != ConstraintType::NOENTRY && checkSubdividedEdge(src, dst);
+}
+
+bool ConstraintBase::checkCollisionFromValidState(const State &src, const State &dst) const {
+  return checkCollision(src, dst);
+}
+
+void ConstraintBase::checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                                         std::vector<bool> &results) const {
+  results.assign(dsts.size(), false);
+  if (checkConstraintType(src) == ConstraintType::NOENTRY) {
+    return;
+  }
+  for (size_t i = 0; i < dsts.size(); i++) {
+    results[i] = checkCollisionFromValidState(src, dsts[i]);
+  }
 }
 
 ConstraintType ConstraintBase::checkConstraintType(const State &state) const {
@@ -51,5 +81,51 @@ ConstraintType ConstraintBase::checkConstraintType(const State &state) const {
 
   return ConstraintType::ENTAERABLE;
 }
+
+double ConstraintBase::calcEdgeCost(const State &src, const State &dst) const { return src.distanceFrom(dst); }
+
+double ConstraintBase::clearance(const State & /*state*/) const { return 0.0; }
+
+std::vector<double> ConstraintBase::calcSubdivisionOrder(const double &dist) const {
+  // the edge is divided into 'num_divisions' intervals whose length is less than resolution
+  const auto resolution = getResolution();
+  if (!(0.0 < resolution) || dist <= resolution) {
+    return std::vector<double>();
+  }
+  const uint64_t num_divisions = std::ceil(dist / resolution);
+
+  // visit j = 1, ..., num_divisions - 1 in bit reversed order of 'num_bits' bits
+  uint32_t num_bits = 0;
+  while ((1ULL << num_bits) < num_divisions) {
+    num_bits++;
+  }
+  std::vector<double> order;
+  order.reserve(num_divisions - 1);
+  for (uint64_t i = 1; i < (1ULL << num_bits); i++) {
+    uint64_t j = 0;
+    for (uint32_t bit = 0; bit < num_bits; bit++) {
+      j |= ((i >> bit) & 1ULL) << (num_bits - bit - 1);
+    }
+    if (j < num_divisions) {
+      order.push_back((double)j / num_divisions);
+    }
+  }
+  return order;
+}
+
+bool ConstraintBase::checkSubdividedEdge(const State &src, const State &dst) const {
+  if (checkConstraintType(dst) == ConstraintType::NOENTRY) {
+    return false;
+  }
+
+  const auto dir = dst - src;
+  for (const auto &t : calcSubdivisionOrder(src.distanceFrom(dst))) {
+    if (checkConstraintType(src + dir * t) == ConstraintType::NOENTRY) {
+      return false;
+    }
+  }
+
+  return true;
+}
 }  // namespace base
 }  // namespace planner
@@ -0,0 +1,189 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/CostGridConstraint/CostGridConstraint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace planner {
+CostGridConstraint::CostGridConstraint(const EuclideanSpace &space) : GridConstraint(space) {}
+
+CostGridConstraint::CostGridConstraint(const EuclideanSpace &space, const std::vector<ConstraintType> &constraint,
+                                       const std::vector<uint32_t> &each_dim_size, const std::vector<double> &costs)
+    : GridConstraint(space) {
+  set(constraint, each_dim_size, costs);
+}
+
+CostGridConstraint::~CostGridConstraint() {}
+
+void CostGridConstraint::set(const std::vector<ConstraintType> &constraint, const std::vector<uint32_t> &each_dim_size,
+                             const std::vector<double> &costs) {
+  if (costs.size() != constraint.size()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of costs is invalid");
+  }
+  for (const auto &cost : costs) {
+    if (!(1.0 <= cost)) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Cost must be 1 or more");
+    }
+  }
+
+  GridConstraint::set(constraint, each_dim_size);
+  costs_ = costs;
+  calcUniformLevels();
+}
+
+const std::vector<double> &CostGridConstraint::getCostsRef() const { return costs_; }
+
+double CostGridConstraint::calcEdgeCost(const State &src, const State &dst) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  const auto len = src.distanceFrom(dst);
+  if (costs_.empty() || len == 0) {
+    return len;
+  }
+  if (costs_.size() != getConstraintRef().size()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Costs do not match the grid");
+  }
+
+  // cell which contains the source state, and direction of the edge
+  const auto &each_dim_size = getEachDimSizeRef();
+  const auto &strides = getStridesRef();
+  std::vector<int64_t> idx(getDim());
+  std::vector<int32_t> step(getDim());
+  std::vector<double> cell_size(getDim());
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+    if (src.vals[i] < bound.low || bound.high < src.vals[i] || dst.vals[i] < bound.low || bound.high < dst.vals[i]) {
+      return std::numeric_limits<double>::max();
+    }
+
+    cell_size[i] = bound.getRange() / each_dim_size[i];
+    idx[i] = std::min<int64_t>((src.vals[i] - bound.low) / cell_size[i], each_dim_size[i] - 1);
+    const auto dir = dst.vals[i] - src.vals[i];
+    step[i] = (0 < dir) ? 1 : ((dir < 0) ? -1 : 0);
+  }
+
+  // integrate over uniform blocks along the edge (t is the parameter of 'src + t * (dst - src)')
+  auto t = 0.0;
+  auto cost = 0.0;
+  std::vector<int64_t> block_low(getDim());
+  while (true) {
+    size_t cell_idx = 0;
+    for (size_t i = 0; i < getDim(); i++) {
+      cell_idx += idx[i] * strides[i];
+    }
+    const auto level = uniform_levels_[cell_idx];
+    const int64_t block_size = 1LL << level;
+
+    // parameter where the edge leaves the block
+    auto t_exit = 1.0;
+    int32_t exit_axis = -1;
+    for (size_t i = 0; i < getDim(); i++) {
+      block_low[i] = (idx[i] >> level) << level;
+      if (step[i] == 0) {
+        continue;
+      }
+      const auto boundary = space.getBound(i + 1).low + (block_low[i] + (0 < step[i] ? block_size : 0)) * cell_size[i];
+      const auto t_boundary = (boundary - src.vals[i]) / (dst.vals[i] - src.vals[i]);
+      if (t_boundary < t_exit) {
+        t_exit = t_boundary;
+        exit_axis = i;
+      }
+    }
+    t_exit = std::max(t_exit, t);
+    cost += costs_[cell_idx] * (t_exit - t);
+    if (exit_axis < 0) {
+      break;
+    }
+    t = t_exit;
+
+    // cell where the edge enters next block
+    for (size_t i = 0; i < getDim(); i++) {
+      if ((int32_t)i == exit_axis) {
+        idx[i] = (0 < step[i]) ? block_low[i] + block_size : block_low[i] - 1;
+      } else if (step[i] != 0) {
+        const auto val = src.vals[i] + t * (dst.vals[i] - src.vals[i]);
+        const int64_t cell = std::floor((val - space.getBound(i + 1).low) / cell_size[i]);
+        const auto block_high = std::min<int64_t>(block_low[i] + block_size, each_dim_size[i]) - 1;
+        idx[i] = std::min(std::max(cell, block_low[i]), block_high);
+      }
+    }
+    if (idx[exit_axis] < 0 || each_dim_size[exit_axis] <= idx[exit_axis]) {
+      break;
+    }
+  }
+
+  return cost * len;
+}
+
+void CostGridConstraint::calcUniformLevels() {
+  const auto &each_dim_size = getEachDimSizeRef();
+  const auto &strides = getStridesRef();
+  uniform_levels_.assign(costs_.size(), 0);
+
+  for (uint8_t level = 1; level < 32; level++) {
+    // min/max of costs in each block of this level
+    std::vector<uint32_t> num_blocks(getDim());
+    std::vector<size_t> block_strides(getDim(), 1);
+    auto is_root = true;
+    for (size_t i = 0; i < getDim(); i++) {
+      num_blocks[i] = ((each_dim_size[i] - 1) >> level) + 1;
+      if (0 < i) {
+        block_strides[i] = block_strides[i - 1] * num_blocks[i - 1];
+      }
+      is_root &= (num_blocks[i] == 1);
+    }
+    const auto total_blocks = block_strides.back() * num_blocks.back();
+    std::vector<double> min_costs(total_blocks, std::numeric_limits<double>::max());
+    std::vector<double> max_costs(total_blocks, std::numeric_limits<double>::lowest());
+
+    std::vector<size_t> block_indices(costs_.size());
+    for (size_t cell_idx = 0; cell_idx < costs_.size(); cell_idx++) {
+      size_t block_idx = 0;
+      for (size_t i = 0; i < getDim(); i++) {
+        block_idx += (((cell_idx / strides[i]) % each_dim_size[i]) >> level) * block_strides[i];
+      }
+      block_indices[cell_idx] = block_idx;
+      min_costs[block_idx] = std::min(min_costs[block_idx], costs_[cell_idx]);
+      max_costs[block_idx] = std::max(max_costs[block_idx], costs_[cell_idx]);
+    }
+
+    // uniform block at this level is also uniform at lower levels
+    auto has_uniform_block = false;
+    for (size_t cell_idx = 0; cell_idx < costs_.size(); cell_idx++) {
+      if (min_costs[block_indices[cell_idx]] == max_costs[block_indices[cell_idx]]) {
+        uniform_levels_[cell_idx] = level;
+        has_uniform_block = true;
+      }
+    }
+    if (!has_uniform_block || is_root) {
+      break;
+    }
+  }
+}
+}  // namespace planner
@@ -25,25 +25,41 @@
 #include <Constraint/GridConstraint/GridConstraint.h>
 
 namespace planner {
-GridConstraint::GridConstraint(const EuclideanSpace &space) : base::ConstraintBase(space) {}
+GridConstraint::GridConstraint(const EuclideanSpace &space) : base::ConstraintBase(space), cell_diagonal_(0.0) {}
 
 GridConstraint::GridConstraint(const EuclideanSpace &space, const std::vector<ConstraintType> &constraint,
                                const std::vector<uint32_t> &each_dim_size)
-    : base::ConstraintBase(space) {
+    : base::ConstraintBase(space), cell_diagonal_(0.0) {
   set(constraint, each_dim_size);
 }
 
 GridConstraint::~GridConstraint() {}
 
 void GridConstraint::set(const std::vector<ConstraintType> &constraint, const std::vector<uint32_t> &each_dim_size) {
+  if (each_dim_size.size() != getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of size is invalid");
+  }
+
+  std::vector<uint32_t> strides(getDim(), 1);
+  for (size_t i = 1; i < getDim(); i++) {
+    strides[i] = strides[i - 1] * each_dim_size[i - 1];
+  }
+  if (strides.back() * each_dim_size.back() != constraint.size()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of constraint is invalid");
+  }
+
   constraint_ = constraint;
   each_dim_size_ = each_dim_size;
+  strides_ = strides;
+  calcDistanceField();
 }
 
 const std::vector<ConstraintType> &GridConstraint::getConstraintRef() const { return constraint_; }
 
 const std::vector<uint32_t> &GridConstraint::getEachDimSizeRef() const { return each_dim_size_; }
 
+const std::vector<uint32_t> &GridConstraint::getStridesRef() const { return strides_; }
+
 State GridConstraint::calcGridIdx(const State &state) const {
   if (getDim() != state.getDim()) {
     throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
@@ -149,6 +165,54 @@ bool GridConstraint::checkCollision(const State &src, const State &dst) const {
   return true;
 }
 
+void GridConstraint::checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                                         std::vector<bool> &results) const {
+  if (getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  results.assign(dsts.size(), false);
+  const auto src_idx = calcGridIdx(src);
+  for (size_t i = 0; i < getDim(); i++) {
+    if (src_idx.vals[i] == -1) {
+      return;
+    }
+  }
+
+  for (size_t di = 0; di < dsts.size(); di++) {
+    if (getDim() != dsts[di].getDim()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+    }
+    const auto dst_idx = calcGridIdx(dsts[di]);
+    auto is_valid = true;
+    for (size_t i = 0; i < getDim(); i++) {
+      if (dst_idx.vals[i] == -1) {
+        is_valid = false;
+        break;
+      }
+    }
+    if (!is_valid) {
+      continue;
+    }
+
+    for (const auto &idx : calcLineIndices(src_idx, dst_idx)) {
+      uint32_t constraint_array_idx = 0;
+      for (size_t i = 0; i < getDim(); i++) {
+        if (each_dim_size_[i] < idx[i]) {
+          is_valid = false;
+          break;
+        }
+        constraint_array_idx += idx[i] * strides_[i];
+      }
+      if (!is_valid || constraint_[constraint_array_idx] == ConstraintType::NOENTRY) {
+        is_valid = false;
+        break;
+      }
+    }
+    results[di] = is_valid;
+  }
+}
+
 ConstraintType GridConstraint::checkConstraintType(const State &state) const {
   if (getDim() != state.getDim()) {
     throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
@@ -194,4 +258,101 @@ ConstraintType GridConstraint::checkConstraintType(const std::vector<uint32_t> &
 
   return constraint_[constraint_array_idx];
 }
+
+double GridConstraint::clearance(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  if (sq_dist_field_.empty()) {
+    return 0.0;
+  }
+
+  // distance to the boundary of space and index of the cell which contains the state
+  auto nearest = std::numeric_limits<double>::max();
+  uint32_t index = 0;
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+    nearest = std::min({nearest, state.vals[i] - bound.low, bound.high - state.vals[i]});
+    if (nearest <= 0.0) {
+      return 0.0;
+    }
+
+    const uint32_t idx = (state.vals[i] - bound.low) * each_dim_size_[i] / bound.getRange();
+    index += std::min(idx, each_dim_size_[i] - 1) * strides_[i];
+  }
+
+  if (sq_dist_field_[index] == 0.0) {
+    return 0.0;
+  }
+  return std::max(std::min(nearest, std::sqrt(sq_dist_field_[index]) - cell_diagonal_), 0.0);
+}
+
+void GridConstraint::calcDistanceField() {
+  const auto inf = std::numeric_limits<double>::infinity();
+  sq_dist_field_.resize(constraint_.size());
+  for (size_t i = 0; i < constraint_.size(); i++) {
+    sq_dist_field_[i] = (constraint_[i] == ConstraintType::NOENTRY) ? 0.0 : inf;
+  }
+
+  // distance transform along each dimension (lower envelope of parabolas)
+  auto sq_cell_diagonal = 0.0;
+  for (size_t di = 0; di < getDim(); di++) {
+    const auto size = each_dim_size_[di];
+    const auto cell_size = space.getBound(di + 1).getRange() / size;
+    sq_cell_diagonal += cell_size * cell_size;
+
+    std::vector<double> f(size);
+    std::vector<uint32_t> v(size);
+    std::vector<double> z(size + 1);
+    for (size_t begin = 0; begin < constraint_.size(); begin++) {
+      // visit each line along the dimension from its first cell
+      if ((begin / strides_[di]) % size != 0) {
+        continue;
+      }
+      for (uint32_t q = 0; q < size; q++) {
+        f[q] = sq_dist_field_[begin + q * strides_[di]];
+      }
+
+      int32_t k = -1;
+      for (uint32_t q = 0; q < size; q++) {
+        if (f[q] == inf) {
+          continue;
+        }
+        const auto x_q = q * cell_size;
+        auto s = -inf;
+        while (0 <= k) {
+          const auto x_v = v[k] * cell_size;
+          s = ((f[q] + x_q * x_q) - (f[v[k]] + x_v * x_v)) / (2.0 * (x_q - x_v));
+          if (z[k] < s) {
+            break;
+          }
+          k--;
+        }
+        if (k < 0) {
+          s = -inf;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = inf;
+      }
+      if (k < 0) {
+        continue;
+      }
+
+      k = 0;
+      for (uint32_t q = 0; q < size; q++) {
+        const auto x_q = q * cell_size;
+        while (z[k + 1] < x_q) {
+          k++;
+        }
+        const auto diff = x_q - v[k] * cell_size;
+        sq_dist_field_[begin + q * strides_[di]] = diff * diff + f[v[k]];
+      }
+    }
+  }
+
+  cell_diagonal_ = std::sqrt(sq_cell_diagonal);
+}
 }  // namespace planner
@@ -0,0 +1,172 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/ManipulatorConstraint/ManipulatorConstraint.h>
+
+#include <algorithm>
+
+namespace planner {
+ManipulatorConstraint::ManipulatorConstraint(const EuclideanSpace &space, const State &base,
+                                             const std::vector<double> &link_lengths, const double &link_radius,
+                                             const std::shared_ptr<const PointCloudConstraint> &world)
+    : ManipulatorConstraint(space, base, link_lengths, link_radius, world,
+                            [world, link_radius](const State &src, const State &dst) {
+                              return world->checkCollision(src, dst, link_radius);
+                            }) {}
+
+ManipulatorConstraint::ManipulatorConstraint(const EuclideanSpace &space, const State &base,
+                                             const std::vector<double> &link_lengths, const double &link_radius,
+                                             const std::shared_ptr<const PolygonConstraint> &world)
+    : ManipulatorConstraint(space, base, link_lengths, link_radius, world,
+                            [world, link_radius](const State &src, const State &dst) {
+                              return world->checkCollision(src, dst, link_radius);
+                            }) {}
+
+ManipulatorConstraint::ManipulatorConstraint(const EuclideanSpace &space, const State &base,
+                                             const std::vector<double> &link_lengths, const double &link_radius,
+                                             const std::shared_ptr<const base::ConstraintBase> &world,
+                                             const LinkChecker &is_link_free)
+    : base::ConstraintBase(space),
+      base_(base),
+      link_lengths_(link_lengths),
+      link_radius_(link_radius),
+      world_(world),
+      is_link_free_(is_link_free) {
+  if (world == nullptr || world->getDim() != 2 || base.getDim() != 2) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "World is invalid");
+  }
+  if (link_lengths.size() != getDim() || link_radius < 0.0) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Link is invalid");
+  }
+  for (const auto &link_length : link_lengths) {
+    if (!(0.0 < link_length)) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Link is invalid");
+    }
+  }
+}
+
+ManipulatorConstraint::~ManipulatorConstraint() {}
+
+const State &ManipulatorConstraint::getBaseRef() const { return base_; }
+
+const std::vector<double> &ManipulatorConstraint::getLinkLengthsRef() const { return link_lengths_; }
+
+double ManipulatorConstraint::getLinkRadius() const { return link_radius_; }
+
+std::vector<State> ManipulatorConstraint::calcForwardKinematics(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  Eigen::MatrixXd xs, ys;
+  calcForwardKinematics(Eigen::Map<const Eigen::RowVectorXd>(state.vals.data(), getDim()), xs, ys);
+
+  std::vector<State> positions;
+  for (size_t j = 0; j <= getDim(); j++) {
+    positions.emplace_back(xs(0, j), ys(0, j));
+  }
+  return positions;
+}
+
+void ManipulatorConstraint::calcForwardKinematics(const Eigen::MatrixXd &states, Eigen::MatrixXd &xs,
+                                                  Eigen::MatrixXd &ys) const {
+  if (states.cols() != getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  // each column is contiguous, so that a link of all configurations is calculated by vectorized operations
+  xs.resize(states.rows(), getDim() + 1);
+  ys.resize(states.rows(), getDim() + 1);
+  xs.col(0).setConstant(base_.vals[0]);
+  ys.col(0).setConstant(base_.vals[1]);
+  Eigen::ArrayXd theta = Eigen::ArrayXd::Zero(states.rows());
+  for (size_t j = 0; j < getDim(); j++) {
+    theta += states.col(j).array();
+    xs.col(j + 1) = xs.col(j).array() + link_lengths_[j] * theta.cos();
+    ys.col(j + 1) = ys.col(j).array() + link_lengths_[j] * theta.sin();
+  }
+}
+
+bool ManipulatorConstraint::checkCollision(const State &src, const State &dst) const {
+  return checkConstraintType(src) != ConstraintType::NOENTRY && checkCollisionFromValidState(src, dst);
+}
+
+bool ManipulatorConstraint::checkCollisionFromValidState(const State &src, const State &dst) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+  if (base::ConstraintBase::checkConstraintType(dst) == ConstraintType::NOENTRY) {
+    return false;
+  }
+
+  // destination, and then interior configurations
+  auto order = calcSubdivisionOrder(src.distanceFrom(dst));
+  order.insert(order.begin(), 1.0);
+
+  const Eigen::Map<const Eigen::RowVectorXd> src_vec(src.vals.data(), getDim());
+  const Eigen::RowVectorXd dir_vec = Eigen::Map<const Eigen::RowVectorXd>(dst.vals.data(), getDim()) - src_vec;
+  Eigen::MatrixXd states, xs, ys;
+  for (size_t begin = 0; begin < order.size(); begin += BATCH_SIZE) {
+    const auto num = std::min<size_t>(BATCH_SIZE, order.size() - begin);
+    states.resize(num, getDim());
+    for (size_t i = 0; i < num; i++) {
+      states.row(i) = src_vec + order[begin + i] * dir_vec;
+    }
+
+    calcForwardKinematics(states, xs, ys);
+    for (size_t i = 0; i < num; i++) {
+      if (!checkLinks(xs, ys, i)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+ConstraintType ManipulatorConstraint::checkConstraintType(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  // return NOENTRY Type if the state is out of range
+  if (base::ConstraintBase::checkConstraintType(state) == ConstraintType::NOENTRY) {
+    return ConstraintType::NOENTRY;
+  }
+
+  Eigen::MatrixXd xs, ys;
+  calcForwardKinematics(Eigen::Map<const Eigen::RowVectorXd>(state.vals.data(), getDim()), xs, ys);
+  return checkLinks(xs, ys, 0) ? ConstraintType::ENTAERABLE : ConstraintType::NOENTRY;
+}
+
+bool ManipulatorConstraint::checkLinks(const Eigen::MatrixXd &xs, const Eigen::MatrixXd &ys,
+                                       const Eigen::Index &row) const {
+  for (size_t j = 0; j < getDim(); j++) {
+    if (!is_link_free_(State(xs(row, j), ys(row, j)), State(xs(row, j + 1), ys(row, j + 1)))) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace planner
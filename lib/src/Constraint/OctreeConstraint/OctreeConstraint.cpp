@@ -0,0 +1,277 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/OctreeConstraint/OctreeConstraint.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace planner {
+OctreeConstraint::OctreeConstraint(const EuclideanSpace &space, const double &leaf_size)
+    : base::ConstraintBase(space), leaf_size_(leaf_size), depth_(0), unknown_type_(ConstraintType::ENTAERABLE) {
+  if (getDim() != 3) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of space must be 3");
+  } else if (!(0.0 < leaf_size)) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of leaf is invalid");
+  }
+
+  // the root octant covers the largest range of space
+  auto max_range = 0.0;
+  for (size_t i = 0; i < 3; i++) {
+    auto bound = space.getBound(i + 1);
+    origin_[i] = bound.low;
+    max_range = std::max(max_range, bound.getRange());
+  }
+  while (leaf_size_ * (1u << depth_) < max_range) {
+    depth_++;
+  }
+  if (MAX_DEPTH < depth_) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of leaf is too small");
+  }
+  clear();
+}
+
+OctreeConstraint::~OctreeConstraint() {}
+
+void OctreeConstraint::clear() {
+  nodes_.assign(1, UNKNOWN);
+  free_blocks_.clear();
+}
+
+void OctreeConstraint::setOccupied(const State &state, const bool &occupied) {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  std::array<uint32_t, 3> key;
+  if (!calcKey(state, key)) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State is out of space");
+  }
+  updateLeaf(key, occupied ? OCCUPIED : FREE);
+}
+
+void OctreeConstraint::setUnknownType(const ConstraintType &unknown_type) { unknown_type_ = unknown_type; }
+
+ConstraintType OctreeConstraint::getUnknownType() const { return unknown_type_; }
+
+double OctreeConstraint::getLeafSize() const { return leaf_size_; }
+
+uint32_t OctreeConstraint::getDepth() const { return depth_; }
+
+size_t OctreeConstraint::getNumNodes() const { return nodes_.size() - 8 * free_blocks_.size(); }
+
+bool OctreeConstraint::checkCollision(const State &src, const State &dst) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  std::array<uint32_t, 3> key;
+  if (!calcKey(src, key) || !calcKey(dst, key)) {
+    return false;
+  }
+
+  // the axis which the segment is parallel to has infinite inverse
+  std::array<double, 3> inv_dir;
+  uint32_t dir_mask = 0;
+  for (size_t i = 0; i < 3; i++) {
+    const auto dir = dst.vals[i] - src.vals[i];
+    inv_dir[i] = (dir == 0) ? std::numeric_limits<double>::infinity() : 1.0 / dir;
+    if (dir < 0) {
+      dir_mask |= 1u << i;
+    }
+  }
+
+  // slab test of the octant [low, low + size] on the parameter of the segment (0 <= t <= 1)
+  const auto overlap = [&](const std::array<double, 3> &low, const double &size) {
+    double t_min = 0.0;
+    double t_max = 1.0;
+    for (size_t i = 0; i < 3; i++) {
+      if (std::isinf(inv_dir[i])) {
+        if (src.vals[i] < low[i] || low[i] + size < src.vals[i]) {
+          return false;
+        }
+        continue;
+      }
+
+      auto t_near = (low[i] - src.vals[i]) * inv_dir[i];
+      auto t_far = (low[i] + size - src.vals[i]) * inv_dir[i];
+      if (inv_dir[i] < 0) {
+        std::swap(t_near, t_far);
+      }
+      t_min = std::max(t_min, t_near);
+      t_max = std::min(t_max, t_far);
+      if (t_max < t_min) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // descend with explicit stack, and children are visited from the side of 'src'
+  // (octants which are free or unknown are skipped as a whole)
+  struct Item {
+    uint32_t node;
+    uint32_t level;
+    std::array<uint32_t, 3> key;
+  };
+  std::array<Item, 7 * MAX_DEPTH + 1> stack;
+  uint32_t stack_size = 0;
+  stack[stack_size++] = Item{0, 0, {0, 0, 0}};
+  while (stack_size != 0) {
+    const auto item = stack[--stack_size];
+    const auto size_in_leaf = 1u << (depth_ - item.level);
+    std::array<double, 3> low;
+    for (size_t i = 0; i < 3; i++) {
+      low[i] = origin_[i] + item.key[i] * leaf_size_;
+    }
+    if (!overlap(low, size_in_leaf * leaf_size_)) {
+      continue;
+    }
+
+    const auto node = nodes_[item.node];
+    if (getState(node) != INNER) {
+      if (isBlocked(getState(node))) {
+        return false;
+      }
+      continue;
+    }
+
+    // push in reverse order so that the nearest child is popped first
+    const auto half = size_in_leaf / 2;
+    for (int32_t k = 7; k >= 0; k--) {
+      const uint32_t child_idx = k ^ dir_mask;
+      Item child{getChild(node, child_idx), item.level + 1, item.key};
+      for (size_t i = 0; i < 3; i++) {
+        if (child_idx & (1u << i)) {
+          child.key[i] += half;
+        }
+      }
+      stack[stack_size++] = child;
+    }
+  }
+
+  return true;
+}
+
+ConstraintType OctreeConstraint::checkConstraintType(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  std::array<uint32_t, 3> key;
+  if (!calcKey(state, key)) {
+    return ConstraintType::NOENTRY;
+  }
+
+  auto node = nodes_[0];
+  for (int32_t level = depth_ - 1; getState(node) == INNER; level--) {
+    const auto child_idx = ((key[0] >> level) & 1) | (((key[1] >> level) & 1) << 1) | (((key[2] >> level) & 1) << 2);
+    node = nodes_[getChild(node, child_idx)];
+  }
+  return isBlocked(getState(node)) ? ConstraintType::NOENTRY : ConstraintType::ENTAERABLE;
+}
+
+bool OctreeConstraint::isBlocked(const uint32_t &state) const {
+  return state == OCCUPIED || (state == UNKNOWN && unknown_type_ == ConstraintType::NOENTRY);
+}
+
+bool OctreeConstraint::calcKey(const State &state, std::array<uint32_t, 3> &key) const {
+  for (size_t i = 0; i < 3; i++) {
+    auto bound = space.getBound(i + 1);
+
+    // return false if the state is out of range
+    if (state.vals[i] < bound.low || bound.high < state.vals[i]) {
+      return false;
+    }
+    key[i] = std::min<uint32_t>((state.vals[i] - origin_[i]) / leaf_size_, (1u << depth_) - 1);
+  }
+
+  return true;
+}
+
+void OctreeConstraint::updateLeaf(const std::array<uint32_t, 3> &key, const NodeState &state) {
+  // descend to the leaf with splitting uniform octants
+  std::array<uint32_t, MAX_DEPTH + 1> path;
+  uint32_t node_idx = 0;
+  for (uint32_t level = 0; level < depth_; level++) {
+    path[level] = node_idx;
+    const auto node_state = getState(nodes_[node_idx]);
+    if (node_state != INNER) {
+      if (node_state == state) {
+        return;
+      }
+      // (nodes_ may be reallocated)
+      const auto block = allocateBlock((NodeState)node_state);
+      nodes_[node_idx] = INNER | (block << STATE_BITS);
+    }
+
+    const auto shift = depth_ - 1 - level;
+    const auto child_idx = ((key[0] >> shift) & 1) | (((key[1] >> shift) & 1) << 1) | (((key[2] >> shift) & 1) << 2);
+    node_idx = getChild(nodes_[node_idx], child_idx);
+  }
+  nodes_[node_idx] = state;
+
+  // merge children which have the same state into their parent
+  for (int32_t level = depth_ - 1; level >= 0; level--) {
+    const auto parent = nodes_[path[level]];
+    const auto first = nodes_[getChild(parent, 0)];
+    if (getState(first) == INNER) {
+      break;
+    }
+    bool is_uniform = true;
+    for (uint32_t child_idx = 1; child_idx < 8; child_idx++) {
+      if (nodes_[getChild(parent, child_idx)] != first) {
+        is_uniform = false;
+        break;
+      }
+    }
+    if (!is_uniform) {
+      break;
+    }
+
+    free_blocks_.push_back(parent >> STATE_BITS);
+    nodes_[path[level]] = first;
+  }
+}
+
+uint32_t OctreeConstraint::allocateBlock(const NodeState &state) {
+  uint32_t block;
+  if (free_blocks_.empty()) {
+    block = (nodes_.size() - 1) / 8;
+    nodes_.resize(nodes_.size() + 8);
+  } else {
+    block = free_blocks_.back();
+    free_blocks_.pop_back();
+  }
+
+  std::fill(nodes_.begin() + 1 + 8 * block, nodes_.begin() + 9 + 8 * block, (uint32_t)state);
+  return block;
+}
+
+uint32_t OctreeConstraint::getState(const uint32_t &node) { return node & STATE_MASK; }
+
+uint32_t OctreeConstraint::getChild(const uint32_t &node, const uint32_t &child_idx) {
+  return 1 + 8 * (node >> STATE_BITS) + child_idx;
+}
+}  // namespace planner
@@ -43,27 +43,118 @@ State PointCloudConstraint::Hypersphere::getState() const { return state_; }
 
 double PointCloudConstraint::Hypersphere::getRadius() const { return radius_; }
 
-PointCloudConstraint::PointCloudConstraint(const EuclideanSpace &space) : base::ConstraintBase(space) {}
+PointCloudConstraint::PointCloudConstraint(const EuclideanSpace &space)
+    : base::ConstraintBase(space),
+      next_id_(0),
+      bvh_(space.getDim(), KERNEL_WIDTH),
+      num_indexed_(0),
+      num_slots_(0),
+      num_removed_(0) {}
 
 PointCloudConstraint::PointCloudConstraint(const EuclideanSpace &space, const std::vector<Hypersphere> &constraint)
-    : base::ConstraintBase(space) {
+    : base::ConstraintBase(space),
+      next_id_(0),
+      bvh_(space.getDim(), KERNEL_WIDTH),
+      num_indexed_(0),
+      num_slots_(0),
+      num_removed_(0) {
   set(constraint);
 }
 
 PointCloudConstraint::~PointCloudConstraint() {}
 
 void PointCloudConstraint::set(const std::vector<Hypersphere> &constraint) {
+  set(std::vector<Hypersphere>(constraint));
+}
+
+void PointCloudConstraint::set(std::vector<Hypersphere> &&constraint) {
   for (const auto &data : constraint) {
     if (getDim() != data.getState().getDim()) {
       throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
     }
   }
 
-  constraint_ = constraint;
+  constraint_ = std::move(constraint);
+  ids_.resize(constraint_.size());
+  std::iota(ids_.begin(), ids_.end(), 0);
+  next_id_ = constraint_.size();
+  rebuild();
+}
+
+uint32_t PointCloudConstraint::add(const Hypersphere &hypersphere) {
+  if (getDim() != hypersphere.getState().getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  const auto id = next_id_++;
+  constraint_.push_back(hypersphere);
+  ids_.push_back(id);
+
+  // append to pending slots which are not indexed by BVH
+  const auto slot = num_slots_;
+  reserveSlots(num_slots_ + 1);
+  num_slots_++;
+  for (size_t di = 0; di < getDim(); di++) {
+    centers_(di, slot) = hypersphere.getState().vals[di];
+  }
+  sq_radii_(slot) = hypersphere.getRadius() * hypersphere.getRadius();
+  entries_[id] = Entry{(uint32_t)constraint_.size() - 1, slot};
+
+  rebuildIfDegraded();
+  return id;
+}
+
+void PointCloudConstraint::remove(const uint32_t &id) {
+  const auto entry = getEntry(id);
+
+  // disable the slot, and shrink the box on BVH if it is indexed
+  sq_radii_(entry.slot) = -1.0;
+  if (entry.slot < num_indexed_) {
+    bvh_.refit(entry.slot, std::vector<double>(getDim(), std::numeric_limits<double>::max()),
+               std::vector<double>(getDim(), std::numeric_limits<double>::lowest()));
+    num_removed_++;
+  }
+
+  // fill the hole by the last hypersphere
+  const auto last_id = ids_.back();
+  constraint_[entry.index] = constraint_.back();
+  ids_[entry.index] = last_id;
+  entries_[last_id].index = entry.index;
+  constraint_.pop_back();
+  ids_.pop_back();
+  entries_.erase(id);
+
+  rebuildIfDegraded();
+}
+
+void PointCloudConstraint::move(const uint32_t &id, const State &state) {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  const auto &entry = getEntry(id);
+  auto &data = constraint_[entry.index];
+  data.setState(state);
+  for (size_t di = 0; di < getDim(); di++) {
+    centers_(di, entry.slot) = state.vals[di];
+  }
+
+  // refit boxes on BVH without rebuilding
+  if (entry.slot < num_indexed_) {
+    std::vector<double> low(getDim());
+    std::vector<double> high(getDim());
+    for (size_t di = 0; di < getDim(); di++) {
+      low[di] = state.vals[di] - data.getRadius();
+      high[di] = state.vals[di] + data.getRadius();
+    }
+    bvh_.refit(entry.slot, low, high);
+  }
 }
 
 const std::vector<PointCloudConstraint::Hypersphere> &PointCloudConstraint::getRef() const { return constraint_; }
 
+const std::vector<uint32_t> &PointCloudConstraint::getIdsRef() const { return ids_; }
+
 bool PointCloudConstraint::checkCollision(const State &src, const State &dst) const {
   if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
     throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
@@ -79,35 +170,117 @@ bool PointCloudConstraint::checkCollision(const State &src, const State &dst) co
     }
   }
 
-  auto dist = src.distanceFrom(dst);
-  for (const auto &data : constraint_) {
-    std::vector<double> sides{dist, src.distanceFrom(data.getState()), dst.distanceFrom(data.getState())};
-    std::sort(sides.begin(), sides.end());
+  const auto dir = dst - src;
+  const auto len2 = dir.dot(dir);
+  const auto inv_len2 = (len2 == 0) ? 0.0 : 1.0 / len2;
+  if (num_indexed_ < num_slots_ && !checkSegmentKernel(src, dir, inv_len2, num_indexed_, num_slots_)) {
+    return false;
+  }
+  return bvh_.traverseSegment(src, dst, [&](const uint32_t &begin, const uint32_t &end) {
+    return checkSegmentKernel(src, dir, inv_len2, begin, end);
+  });
+}
 
-    // calc most minimum distance between a state on the line and the center of
-    // the hypersphere
-    auto min_dist_from_line = std::numeric_limits<double>::max();
+bool PointCloudConstraint::checkCollision(const State &src, const State &dst, const double &margin) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+  if (margin <= 0.0) {
+    return checkCollision(src, dst);
+  }
 
-    // when triangle is sharp or most long side is "src-dst"
-    if (sides[2] == dist || std::pow(sides[2], 2) <= std::pow(sides[1], 2) + std::pow(sides[0], 2)) {
-      // calc area of ​​the triangle by using Heron's formula
-      auto s = std::accumulate(sides.begin(), sides.end(), 0.0) / 2.0;
-      auto S = std::sqrt(s * (s - sides[0]) * (s - sides[1]) * (s - sides[2]));
+  auto low = src;
+  auto high = src;
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+    if (src.vals[i] < bound.low || bound.high < src.vals[i] || dst.vals[i] < bound.low || bound.high < dst.vals[i]) {
+      return false;
+    }
+    low.vals[i] = std::min(src.vals[i], dst.vals[i]) - margin;
+    high.vals[i] = std::max(src.vals[i], dst.vals[i]) + margin;
+  }
+
+  const auto dir = dst - src;
+  const auto len2 = dir.dot(dir);
+  const auto inv_len2 = (len2 == 0) ? 0.0 : 1.0 / len2;
+  if (num_indexed_ < num_slots_ && !checkSegmentKernel(src, dir, inv_len2, num_indexed_, num_slots_, margin)) {
+    return false;
+  }
+  return bvh_.traverseBox(low, high, [&](const uint32_t &begin, const uint32_t &end) {
+    return checkSegmentKernel(src, dir, inv_len2, begin, end, margin);
+  });
+}
+
+void PointCloudConstraint::checkCollisionBatch(const State &src, const std::vector<State> &dsts,
+                                               std::vector<bool> &results) const {
+  if (getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
 
-      min_dist_from_line = (S * 2) / dist;
-    } else {
-      for (const auto &side : sides) {
-        if (side != dist) {
-          min_dist_from_line = std::min(min_dist_from_line, side);
-        }
+  results.assign(dsts.size(), false);
+  const auto is_in_space = [&](const State &state) {
+    for (size_t i = 0; i < getDim(); i++) {
+      auto bound = space.getBound(i + 1);
+      if (state.vals[i] < bound.low || bound.high < state.vals[i]) {
+        return false;
       }
     }
+    return true;
+  };
+  if (!is_in_space(src)) {
+    return;
+  }
 
-    if (min_dist_from_line <= data.getRadius()) {
-      return false;
+  // edges which remain to be tested and the bounding box of them
+  std::vector<uint32_t> edge_indices;
+  std::vector<State> dirs;
+  std::vector<double> inv_len2s;
+  auto low = src;
+  auto high = src;
+  for (size_t di = 0; di < dsts.size(); di++) {
+    if (getDim() != dsts[di].getDim()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+    }
+    if (!is_in_space(dsts[di])) {
+      continue;
+    }
+
+    edge_indices.push_back(di);
+    dirs.push_back(dsts[di] - src);
+    const auto len2 = dirs.back().dot(dirs.back());
+    inv_len2s.push_back((len2 == 0) ? 0.0 : 1.0 / len2);
+    for (size_t i = 0; i < getDim(); i++) {
+      low.vals[i] = std::min(low.vals[i], dsts[di].vals[i]);
+      high.vals[i] = std::max(high.vals[i], dsts[di].vals[i]);
     }
   }
-  return true;
+
+  // an edge is removed from the remaining edges as soon as it touches a hypersphere
+  const auto check_range = [&](const uint32_t &begin, const uint32_t &end) {
+    for (size_t ei = 0; ei < edge_indices.size();) {
+      if (checkSegmentKernel(src, dirs[ei], inv_len2s[ei], begin, end)) {
+        ei++;
+      } else {
+        edge_indices[ei] = edge_indices.back();
+        dirs[ei] = dirs.back();
+        inv_len2s[ei] = inv_len2s.back();
+        edge_indices.pop_back();
+        dirs.pop_back();
+        inv_len2s.pop_back();
+      }
+    }
+    return !edge_indices.empty();
+  };
+
+  if (!edge_indices.empty() && num_indexed_ < num_slots_) {
+    check_range(num_indexed_, num_slots_);
+  }
+  if (!edge_indices.empty()) {
+    bvh_.traverseBox(low, high, check_range);
+  }
+  for (const auto &edge_index : edge_indices) {
+    results[edge_index] = true;
+  }
 }
 
 ConstraintType PointCloudConstraint::checkConstraintType(const State &state) const {
@@ -125,12 +298,166 @@ ConstraintType PointCloudConstraint::checkConstraintType(const State &state) con
     }
   }
 
-  for (const auto &data : constraint_) {
-    if (state.distanceFrom(data.getState()) < data.getRadius()) {
-      return ConstraintType::NOENTRY;
+  if (num_indexed_ < num_slots_ && !checkPointKernel(state, num_indexed_, num_slots_)) {
+    return ConstraintType::NOENTRY;
+  }
+  const auto is_free = bvh_.traversePoint(
+      state, [&](const uint32_t &begin, const uint32_t &end) { return checkPointKernel(state, begin, end); });
+
+  return is_free ? ConstraintType::ENTAERABLE : ConstraintType::NOENTRY;
+}
+
+double PointCloudConstraint::clearance(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  // distance to the boundary of space
+  auto nearest = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+    nearest = std::min({nearest, state.vals[i] - bound.low, bound.high - state.vals[i]});
+  }
+  if (nearest <= 0.0) {
+    return 0.0;
+  }
+
+  if (num_indexed_ < num_slots_) {
+    nearest = std::min(nearest, calcDistanceKernel(state, num_indexed_, num_slots_));
+  }
+  nearest = bvh_.traverseNearest(state, nearest, [&](const uint32_t &begin, const uint32_t &end) {
+    return calcDistanceKernel(state, begin, end);
+  });
+
+  return std::max(nearest, 0.0);
+}
+
+bool PointCloudConstraint::checkSegmentKernel(const State &src, const State &dir, const double &inv_len2,
+                                              const uint32_t &begin, const uint32_t &end, const double &margin) const {
+  // the padding guarantees that KERNEL_WIDTH columns from 'begin' are readable,
+  // and extra hyperspheres out of the range are tested exactly as well
+  for (uint32_t oi = begin; oi < end; oi += KERNEL_WIDTH) {
+    // parameter of the closest point on the segment (clamped to [0, 1])
+    KernelArray t = KernelArray::Zero();
+    for (size_t di = 0; di < getDim(); di++) {
+      const Eigen::Map<const KernelArray> center(&centers_(di, oi));
+      t += (center - src.vals[di]) * dir.vals[di];
+    }
+    t = (t * inv_len2).max(0.0).min(1.0);
+
+    // squared distance between the closest point and the center
+    KernelArray sq_dist = KernelArray::Zero();
+    for (size_t di = 0; di < getDim(); di++) {
+      const Eigen::Map<const KernelArray> center(&centers_(di, oi));
+      sq_dist += (center - src.vals[di] - t * dir.vals[di]).square();
+    }
+
+    const Eigen::Map<const KernelArray> sq_radii(&sq_radii_(oi));
+    if (margin == 0.0) {
+      if ((sq_dist <= sq_radii).any()) {
+        return false;
+      }
+    } else if ((0.0 <= sq_radii && sq_dist <= (sq_radii.max(0.0).sqrt() + margin).square()).any()) {
+      // (hypersphere which has negative squared radius is ignored)
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool PointCloudConstraint::checkPointKernel(const State &state, const uint32_t &begin, const uint32_t &end) const {
+  for (uint32_t oi = begin; oi < end; oi += KERNEL_WIDTH) {
+    KernelArray sq_dist = KernelArray::Zero();
+    for (size_t di = 0; di < getDim(); di++) {
+      const Eigen::Map<const KernelArray> center(&centers_(di, oi));
+      sq_dist += (center - state.vals[di]).square();
+    }
+
+    if ((sq_dist < Eigen::Map<const KernelArray>(&sq_radii_(oi))).any()) {
+      return false;
     }
   }
 
-  return ConstraintType::ENTAERABLE;
+  return true;
+}
+
+double PointCloudConstraint::calcDistanceKernel(const State &state, const uint32_t &begin, const uint32_t &end) const {
+  auto nearest = std::numeric_limits<double>::max();
+  for (uint32_t oi = begin; oi < end; oi += KERNEL_WIDTH) {
+    KernelArray sq_dist = KernelArray::Zero();
+    for (size_t di = 0; di < getDim(); di++) {
+      const Eigen::Map<const KernelArray> center(&centers_(di, oi));
+      sq_dist += (center - state.vals[di]).square();
+    }
+
+    // padding and removed hyperspheres have negative squared radius
+    const Eigen::Map<const KernelArray> sq_radii(&sq_radii_(oi));
+    const KernelArray dist = sq_dist.sqrt() - sq_radii.max(0.0).sqrt();
+    nearest = std::min(nearest, (sq_radii < 0.0).select(std::numeric_limits<double>::max(), dist).minCoeff());
+  }
+
+  return nearest;
+}
+
+void PointCloudConstraint::rebuild() {
+  // build BVH from bounding box of each hypersphere
+  std::vector<double> lows(getDim() * constraint_.size());
+  std::vector<double> highs(getDim() * constraint_.size());
+  for (size_t i = 0; i < constraint_.size(); i++) {
+    const auto state = constraint_[i].getState();
+    const auto radius = constraint_[i].getRadius();
+    for (size_t di = 0; di < getDim(); di++) {
+      lows[i * getDim() + di] = state.vals[di] - radius;
+      highs[i * getDim() + di] = state.vals[di] + radius;
+    }
+  }
+  bvh_.build(lows, highs);
+
+  // store hyperspheres in leaf order of BVH
+  const auto &order = bvh_.getOrderRef();
+  centers_.setZero(getDim(), constraint_.size() + KERNEL_WIDTH);
+  sq_radii_.setConstant(constraint_.size() + KERNEL_WIDTH, -1.0);
+  entries_.clear();
+  for (size_t oi = 0; oi < order.size(); oi++) {
+    const auto &data = constraint_[order[oi]];
+    for (size_t di = 0; di < getDim(); di++) {
+      centers_(di, oi) = data.getState().vals[di];
+    }
+    sq_radii_(oi) = data.getRadius() * data.getRadius();
+    entries_[ids_[order[oi]]] = Entry{order[oi], (uint32_t)oi};
+  }
+
+  num_indexed_ = constraint_.size();
+  num_slots_ = constraint_.size();
+  num_removed_ = 0;
+}
+
+void PointCloudConstraint::rebuildIfDegraded() {
+  const auto num_updated = (num_slots_ - num_indexed_) + num_removed_;
+  if (std::max<double>(REBUILD_RATIO * num_indexed_, KERNEL_WIDTH) < num_updated) {
+    rebuild();
+  }
+}
+
+void PointCloudConstraint::reserveSlots(const uint32_t &num_slots) {
+  const auto capacity = centers_.cols();
+  if (num_slots + KERNEL_WIDTH <= capacity) {
+    return;
+  }
+
+  const auto new_capacity = std::max<Eigen::Index>(2 * capacity, num_slots + KERNEL_WIDTH);
+  centers_.conservativeResize(getDim(), new_capacity);
+  sq_radii_.conservativeResize(new_capacity);
+  centers_.rightCols(new_capacity - capacity).setZero();
+  sq_radii_.tail(new_capacity - capacity).setConstant(-1.0);
+}
+
+const PointCloudConstraint::Entry &PointCloudConstraint::getEntry(const uint32_t &id) const {
+  const auto itr = entries_.find(id);
+  if (itr == entries_.end()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Id is invalid");
+  }
+  return itr->second;
 }
 }  // namespace planner
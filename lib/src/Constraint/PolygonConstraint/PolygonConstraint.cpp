@@ -0,0 +1,246 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/PolygonConstraint/PolygonConstraint.h>
+
+namespace planner {
+PolygonConstraint::Polygon::Polygon(const std::vector<State> &vertices) : vertices_(vertices) {
+  if (vertices.size() < 3) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Polygon is invalid");
+  }
+  for (const auto &vertex : vertices) {
+    if (vertex.getDim() != 2) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+    }
+  }
+}
+
+const std::vector<State> &PolygonConstraint::Polygon::getVerticesRef() const { return vertices_; }
+
+PolygonConstraint::PolygonConstraint(const EuclideanSpace &space)
+    : base::ConstraintBase(space), edge_bvh_(2), polygon_bvh_(2) {
+  if (getDim() != 2) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of space must be 2");
+  }
+}
+
+PolygonConstraint::PolygonConstraint(const EuclideanSpace &space, const std::vector<Polygon> &polygons)
+    : PolygonConstraint(space) {
+  set(polygons);
+}
+
+PolygonConstraint::~PolygonConstraint() {}
+
+void PolygonConstraint::set(const std::vector<Polygon> &polygons) {
+  polygons_ = polygons;
+
+  // build BVH from bounding box of each edge and each polygon
+  edges_.clear();
+  std::vector<double> edge_lows;
+  std::vector<double> edge_highs;
+  std::vector<double> polygon_lows(2 * polygons_.size(), std::numeric_limits<double>::max());
+  std::vector<double> polygon_highs(2 * polygons_.size(), std::numeric_limits<double>::lowest());
+  for (size_t pi = 0; pi < polygons_.size(); pi++) {
+    const auto &vertices = polygons_[pi].getVerticesRef();
+    for (size_t vi = 0; vi < vertices.size(); vi++) {
+      const auto &v0 = vertices[vi];
+      const auto &v1 = vertices[(vi + 1) % vertices.size()];
+      edges_.push_back(Edge{v0.vals[0], v0.vals[1], v1.vals[0], v1.vals[1]});
+      for (size_t i = 0; i < 2; i++) {
+        edge_lows.push_back(std::min(v0.vals[i], v1.vals[i]));
+        edge_highs.push_back(std::max(v0.vals[i], v1.vals[i]));
+        polygon_lows[2 * pi + i] = std::min(polygon_lows[2 * pi + i], v0.vals[i]);
+        polygon_highs[2 * pi + i] = std::max(polygon_highs[2 * pi + i], v0.vals[i]);
+      }
+    }
+  }
+  edge_bvh_.build(edge_lows, edge_highs);
+  polygon_bvh_.build(polygon_lows, polygon_highs);
+}
+
+const std::vector<PolygonConstraint::Polygon> &PolygonConstraint::getRef() const { return polygons_; }
+
+bool PolygonConstraint::checkCollision(const State &src, const State &dst) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  // the segment which crosses no edge is entirely inside or outside of each polygon,
+  // so that the source state decides it
+  if (checkConstraintType(dst) == ConstraintType::NOENTRY) {
+    return false;
+  }
+  const auto &order = edge_bvh_.getOrderRef();
+  const auto is_free = edge_bvh_.traverseSegment(src, dst, [&](const uint32_t &begin, const uint32_t &end) {
+    for (auto oi = begin; oi < end; oi++) {
+      if (intersectSegment(edges_[order[oi]], src, dst)) {
+        return false;
+      }
+    }
+    return true;
+  });
+  return is_free && checkConstraintType(src) == ConstraintType::ENTAERABLE;
+}
+
+bool PolygonConstraint::checkCollision(const State &src, const State &dst, const double &margin) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+  if (margin <= 0.0) {
+    return checkCollision(src, dst);
+  }
+
+  if (checkConstraintType(dst) == ConstraintType::NOENTRY) {
+    return false;
+  }
+  State low(std::min(src.vals[0], dst.vals[0]) - margin, std::min(src.vals[1], dst.vals[1]) - margin);
+  State high(std::max(src.vals[0], dst.vals[0]) + margin, std::max(src.vals[1], dst.vals[1]) + margin);
+  const auto &order = edge_bvh_.getOrderRef();
+  const auto is_free = edge_bvh_.traverseBox(low, high, [&](const uint32_t &begin, const uint32_t &end) {
+    for (auto oi = begin; oi < end; oi++) {
+      if (calcDistance(edges_[order[oi]], src, dst) <= margin) {
+        return false;
+      }
+    }
+    return true;
+  });
+  return is_free && checkConstraintType(src) == ConstraintType::ENTAERABLE;
+}
+
+ConstraintType PolygonConstraint::checkConstraintType(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  // return NOENTRY Type if the state is out of range
+  if (base::ConstraintBase::checkConstraintType(state) == ConstraintType::NOENTRY) {
+    return ConstraintType::NOENTRY;
+  }
+
+  const auto &order = polygon_bvh_.getOrderRef();
+  const auto is_free = polygon_bvh_.traversePoint(state, [&](const uint32_t &begin, const uint32_t &end) {
+    for (auto oi = begin; oi < end; oi++) {
+      if (containPoint(polygons_[order[oi]], state)) {
+        return false;
+      }
+    }
+    return true;
+  });
+  return is_free ? ConstraintType::ENTAERABLE : ConstraintType::NOENTRY;
+}
+
+double PolygonConstraint::clearance(const State &state) const {
+  if (checkConstraintType(state) == ConstraintType::NOENTRY) {
+    return 0.0;
+  }
+
+  // distance to the boundary of space
+  auto nearest = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+    nearest = std::min({nearest, state.vals[i] - bound.low, bound.high - state.vals[i]});
+  }
+
+  const auto &order = edge_bvh_.getOrderRef();
+  return edge_bvh_.traverseNearest(state, nearest, [&](const uint32_t &begin, const uint32_t &end) {
+    auto leaf_nearest = std::numeric_limits<double>::max();
+    for (auto oi = begin; oi < end; oi++) {
+      leaf_nearest = std::min(leaf_nearest, calcDistance(edges_[order[oi]], state));
+    }
+    return leaf_nearest;
+  });
+}
+
+bool PolygonConstraint::containPoint(const Polygon &polygon, const State &state) {
+  const auto px = state.vals[0];
+  const auto py = state.vals[1];
+  const auto &vertices = polygon.getVerticesRef();
+  int32_t winding_number = 0;
+  for (size_t vi = 0; vi < vertices.size(); vi++) {
+    const auto &v0 = vertices[vi];
+    const auto &v1 = vertices[(vi + 1) % vertices.size()];
+    const auto orientation = calcCross(v0.vals[0], v0.vals[1], v1.vals[0], v1.vals[1], px, py);
+    if (orientation == 0 && isOnSegment(v0.vals[0], v0.vals[1], v1.vals[0], v1.vals[1], px, py)) {
+      return true;
+    }
+
+    // count upward crossings on the left and downward crossings on the right
+    if (v0.vals[1] <= py) {
+      if (py < v1.vals[1] && 0 < orientation) {
+        winding_number++;
+      }
+    } else if (v1.vals[1] <= py && orientation < 0) {
+      winding_number--;
+    }
+  }
+
+  return winding_number != 0;
+}
+
+bool PolygonConstraint::intersectSegment(const Edge &edge, const State &src, const State &dst) {
+  const auto d1 = calcCross(src.vals[0], src.vals[1], dst.vals[0], dst.vals[1], edge[0], edge[1]);
+  const auto d2 = calcCross(src.vals[0], src.vals[1], dst.vals[0], dst.vals[1], edge[2], edge[3]);
+  const auto d3 = calcCross(edge[0], edge[1], edge[2], edge[3], src.vals[0], src.vals[1]);
+  const auto d4 = calcCross(edge[0], edge[1], edge[2], edge[3], dst.vals[0], dst.vals[1]);
+  if (((0 < d1 && d2 < 0) || (d1 < 0 && 0 < d2)) && ((0 < d3 && d4 < 0) || (d3 < 0 && 0 < d4))) {
+    return true;
+  }
+
+  // an end point lies on the other segment
+  return (d1 == 0 && isOnSegment(src.vals[0], src.vals[1], dst.vals[0], dst.vals[1], edge[0], edge[1])) ||
+         (d2 == 0 && isOnSegment(src.vals[0], src.vals[1], dst.vals[0], dst.vals[1], edge[2], edge[3])) ||
+         (d3 == 0 && isOnSegment(edge[0], edge[1], edge[2], edge[3], src.vals[0], src.vals[1])) ||
+         (d4 == 0 && isOnSegment(edge[0], edge[1], edge[2], edge[3], dst.vals[0], dst.vals[1]));
+}
+
+double PolygonConstraint::calcCross(const double &ox, const double &oy, const double &ax, const double &ay,
+                                    const double &bx, const double &by) {
+  return (ax - ox) * (by - oy) - (ay - oy) * (bx - ox);
+}
+
+bool PolygonConstraint::isOnSegment(const double &ax, const double &ay, const double &bx, const double &by,
+                                    const double &px, const double &py) {
+  return std::min(ax, bx) <= px && px <= std::max(ax, bx) && std::min(ay, by) <= py && py <= std::max(ay, by);
+}
+
+double PolygonConstraint::calcDistance(const Edge &edge, const State &state) {
+  const auto dx = edge[2] - edge[0];
+  const auto dy = edge[3] - edge[1];
+  const auto len2 = dx * dx + dy * dy;
+  auto t = (len2 == 0) ? 0.0 : ((state.vals[0] - edge[0]) * dx + (state.vals[1] - edge[1]) * dy) / len2;
+  t = std::max(0.0, std::min(1.0, t));
+  return std::hypot(state.vals[0] - edge[0] - t * dx, state.vals[1] - edge[1] - t * dy);
+}
+
+double PolygonConstraint::calcDistance(const Edge &edge, const State &src, const State &dst) {
+  if (intersectSegment(edge, src, dst)) {
+    return 0.0;
+  }
+
+  // the nearest points are the end point of either segment
+  const Edge segment{src.vals[0], src.vals[1], dst.vals[0], dst.vals[1]};
+  return std::min({calcDistance(edge, src), calcDistance(edge, dst), calcDistance(segment, State(edge[0], edge[1])),
+                   calcDistance(segment, State(edge[2], edge[3]))});
+}
+}  // namespace planner
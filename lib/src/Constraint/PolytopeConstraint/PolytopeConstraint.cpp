@@ -0,0 +1,379 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/PolytopeConstraint/PolytopeConstraint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace planner {
+PolytopeConstraint::Box::Box(const State &low, const State &high) : low_(low), high_(high) {
+  if (low.getDim() != high.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+  for (size_t i = 0; i < low.getDim(); i++) {
+    if (high.vals[i] < low.vals[i]) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Box is invalid");
+    }
+  }
+}
+
+const State &PolytopeConstraint::Box::getLow() const { return low_; }
+
+const State &PolytopeConstraint::Box::getHigh() const { return high_; }
+
+PolytopeConstraint::Polytope::Polytope(const Eigen::MatrixXd &A, const Eigen::VectorXd &b) : A_(A), b_(b) {
+  if (A.rows() != b.rows() || A.rows() == 0) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Half-spaces are invalid");
+  }
+}
+
+const Eigen::MatrixXd &PolytopeConstraint::Polytope::getA() const { return A_; }
+
+const Eigen::VectorXd &PolytopeConstraint::Polytope::getB() const { return b_; }
+
+PolytopeConstraint::PolytopeConstraint(const EuclideanSpace &space)
+    : base::ConstraintBase(space), bvh_(space.getDim()) {}
+
+PolytopeConstraint::PolytopeConstraint(const EuclideanSpace &space, const std::vector<Box> &boxes,
+                                       const std::vector<Polytope> &polytopes)
+    : base::ConstraintBase(space), bvh_(space.getDim()) {
+  set(boxes, polytopes);
+}
+
+PolytopeConstraint::~PolytopeConstraint() {}
+
+void PolytopeConstraint::set(const std::vector<Box> &boxes, const std::vector<Polytope> &polytopes) {
+  for (const auto &box : boxes) {
+    if (getDim() != box.getLow().getDim()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+    }
+  }
+  for (const auto &polytope : polytopes) {
+    if (getDim() != polytope.getA().cols()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Polytope dimension is invalid");
+    }
+  }
+
+  boxes_ = boxes;
+  polytopes_ = polytopes;
+
+  // build BVH from bounding box of each obstacle
+  const auto num = boxes_.size() + polytopes_.size();
+  std::vector<double> lows(getDim() * num);
+  std::vector<double> highs(getDim() * num);
+  for (size_t i = 0; i < boxes_.size(); i++) {
+    std::copy(boxes_[i].getLow().vals.begin(), boxes_[i].getLow().vals.end(), lows.begin() + i * getDim());
+    std::copy(boxes_[i].getHigh().vals.begin(), boxes_[i].getHigh().vals.end(), highs.begin() + i * getDim());
+  }
+  for (size_t i = 0; i < polytopes_.size(); i++) {
+    const auto offset = (boxes_.size() + i) * getDim();
+    calcPolytopeBound(polytopes_[i], &lows[offset], &highs[offset]);
+  }
+  bvh_.build(lows, highs);
+}
+
+const std::vector<PolytopeConstraint::Box> &PolytopeConstraint::getBoxesRef() const { return boxes_; }
+
+const std::vector<PolytopeConstraint::Polytope> &PolytopeConstraint::getPolytopesRef() const { return polytopes_; }
+
+bool PolytopeConstraint::checkCollision(const State &src, const State &dst) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+
+    // return NOENTRY Type if the state is out of range
+    if (src.vals[i] < bound.low || bound.high < src.vals[i] || dst.vals[i] < bound.low || bound.high < dst.vals[i]) {
+      return false;
+    }
+  }
+
+  Eigen::Matrix<double, Eigen::Dynamic, 2> src_dir(getDim(), 2);
+  for (size_t i = 0; i < getDim(); i++) {
+    src_dir(i, 0) = src.vals[i];
+    src_dir(i, 1) = dst.vals[i] - src.vals[i];
+  }
+
+  const auto &order = bvh_.getOrderRef();
+  return bvh_.traverseSegment(src, dst, [&](const uint32_t &begin, const uint32_t &end) {
+    for (uint32_t oi = begin; oi < end; oi++) {
+      const auto idx = order[oi];
+      if (idx < boxes_.size() ? intersectBox(boxes_[idx], src, dst)
+                              : intersectPolytope(polytopes_[idx - boxes_.size()], src_dir)) {
+        return false;
+      }
+    }
+    return true;
+  });
+}
+
+ConstraintType PolytopeConstraint::checkConstraintType(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  for (size_t i = 0; i < getDim(); i++) {
+    auto bound = space.getBound(i + 1);
+
+    // return NOENTRY Type if the state is out of range
+    if (state.vals[i] < bound.low || bound.high < state.vals[i]) {
+      return ConstraintType::NOENTRY;
+    }
+  }
+
+  const Eigen::Map<const Eigen::VectorXd> x(state.vals.data(), getDim());
+  const auto &order = bvh_.getOrderRef();
+  const auto is_free = bvh_.traversePoint(state, [&](const uint32_t &begin, const uint32_t &end) {
+    for (uint32_t oi = begin; oi < end; oi++) {
+      const auto idx = order[oi];
+      if (idx < boxes_.size()) {
+        const auto &box = boxes_[idx];
+        if ((x.array() >= Eigen::Map<const Eigen::ArrayXd>(box.getLow().vals.data(), getDim())).all() &&
+            (x.array() <= Eigen::Map<const Eigen::ArrayXd>(box.getHigh().vals.data(), getDim())).all()) {
+          return false;
+        }
+        continue;
+      }
+
+      const auto &polytope = polytopes_[idx - boxes_.size()];
+      if (((polytope.getA() * x - polytope.getB()).array() <= 0).all()) {
+        return false;
+      }
+    }
+    return true;
+  });
+
+  return is_free ? ConstraintType::ENTAERABLE : ConstraintType::NOENTRY;
+}
+
+void PolytopeConstraint::calcPolytopeBound(const Polytope &polytope, double *low, double *high) const {
+  // variables are shifted by the lower bound of space so that they are non-negative ('x = space_low + y'),
+  // and the rows are the half-spaces of polytope and the upper bound of space ('A * y <= b', 'y >= 0')
+  const int dim = getDim();
+  const int num_polytope_rows = polytope.getA().rows();
+  const int num_rows = num_polytope_rows + dim;
+  Eigen::VectorXd space_low(dim);
+  for (int di = 0; di < dim; di++) {
+    space_low(di) = space.getBound(di + 1).low;
+  }
+  Eigen::MatrixXd A = Eigen::MatrixXd::Zero(num_rows, dim);
+  Eigen::VectorXd b(num_rows);
+  A.topRows(num_polytope_rows) = polytope.getA();
+  b.head(num_polytope_rows) = polytope.getB() - polytope.getA() * space_low;
+  A.bottomRows(dim).setIdentity();
+  for (int di = 0; di < dim; di++) {
+    b(num_polytope_rows + di) = space.getBound(di + 1).high - space_low(di);
+  }
+
+  // tableau of 'A * y + s = b' (columns are y, slack s, artificial variables and right hand side)
+  // where a row whose right hand side is negative is negated and has an artificial variable
+  std::vector<int> artificial_rows;
+  for (int ri = 0; ri < num_rows; ri++) {
+    if (b(ri) < 0) {
+      artificial_rows.push_back(ri);
+    }
+  }
+  const int num_vars = dim + num_rows;
+  const int num_cols = num_vars + artificial_rows.size();
+  Eigen::MatrixXd tableau = Eigen::MatrixXd::Zero(num_rows, num_cols + 1);
+  std::vector<int> basis(num_rows);
+  tableau.leftCols(dim) = A;
+  tableau.block(0, dim, num_rows, num_rows).setIdentity();
+  tableau.col(num_cols) = b;
+  for (int ri = 0; ri < num_rows; ri++) {
+    basis[ri] = dim + ri;
+  }
+  for (size_t ai = 0; ai < artificial_rows.size(); ai++) {
+    const auto ri = artificial_rows[ai];
+    tableau.row(ri) *= -1.0;
+    tableau(ri, num_vars + ai) = 1.0;
+    basis[ri] = num_vars + ai;
+  }
+
+  // phase 1: minimize the sum of artificial variables to find a vertex of the clipped polytope
+  std::fill(low, low + dim, std::numeric_limits<double>::max());
+  std::fill(high, high + dim, std::numeric_limits<double>::lowest());
+  const auto tolerance = 1e-9 * (1.0 + b.cwiseAbs().maxCoeff());
+  if (!artificial_rows.empty()) {
+    Eigen::VectorXd objective = Eigen::VectorXd::Zero(num_cols);
+    objective.tail(artificial_rows.size()).setConstant(-1.0);
+    if (runSimplex(tableau, basis, objective, num_cols) < -tolerance) {
+      return;
+    }
+
+    // move remaining artificial variables (whose value is zero) out of the basis
+    // (a row which has no other non-zero coefficient is redundant and never changes)
+    for (int ri = 0; ri < num_rows; ri++) {
+      if (basis[ri] < num_vars) {
+        continue;
+      }
+      for (int ci = 0; ci < num_vars; ci++) {
+        if (tolerance < std::abs(tableau(ri, ci))) {
+          pivotTableau(tableau, basis, ri, ci);
+          break;
+        }
+      }
+    }
+  }
+
+  // phase 2: minimize and maximize each variable from the vertex (artificial variables never enter)
+  for (int di = 0; di < dim; di++) {
+    for (const auto &sign : {-1.0, 1.0}) {
+      auto phase2_tableau = tableau;
+      auto phase2_basis = basis;
+      Eigen::VectorXd objective = Eigen::VectorXd::Zero(num_vars);
+      objective(di) = sign;
+      const auto value = sign * runSimplex(phase2_tableau, phase2_basis, objective, num_vars);
+      if (sign < 0) {
+        low[di] = space_low(di) + value;
+      } else {
+        high[di] = space_low(di) + value;
+      }
+    }
+  }
+}
+
+double PolytopeConstraint::runSimplex(Eigen::MatrixXd &tableau, std::vector<int> &basis,
+                                      const Eigen::VectorXd &objective, const int &num_entering_cols) {
+  const int num_rows = tableau.rows();
+  const int rhs_col = tableau.cols() - 1;
+  const auto basis_objective = [&](const int &ri) {
+    return (basis[ri] < objective.size()) ? objective(basis[ri]) : 0.0;
+  };
+
+  while (true) {
+    // entering column is the first one which improves the objective (Bland's rule never cycles)
+    int entering_col = -1;
+    for (int ci = 0; ci < num_entering_cols && entering_col < 0; ci++) {
+      auto reduced_cost = objective(ci);
+      for (int ri = 0; ri < num_rows; ri++) {
+        reduced_cost -= basis_objective(ri) * tableau(ri, ci);
+      }
+      if (1e-12 < reduced_cost) {
+        entering_col = ci;
+      }
+    }
+    if (entering_col < 0) {
+      break;
+    }
+
+    // leaving row by minimum ratio test (ties are broken by the smallest basic variable)
+    int leaving_row = -1;
+    auto min_ratio = std::numeric_limits<double>::max();
+    for (int ri = 0; ri < num_rows; ri++) {
+      if (tableau(ri, entering_col) <= 1e-12) {
+        continue;
+      }
+      const auto ratio = tableau(ri, rhs_col) / tableau(ri, entering_col);
+      if (leaving_row < 0 || ratio < min_ratio || (ratio == min_ratio && basis[ri] < basis[leaving_row])) {
+        min_ratio = ratio;
+        leaving_row = ri;
+      }
+    }
+    if (leaving_row < 0) {
+      // (every variable is bounded by the bound of space)
+      break;
+    }
+    pivotTableau(tableau, basis, leaving_row, entering_col);
+  }
+
+  auto value = 0.0;
+  for (int ri = 0; ri < num_rows; ri++) {
+    value += basis_objective(ri) * tableau(ri, rhs_col);
+  }
+  return value;
+}
+
+void PolytopeConstraint::pivotTableau(Eigen::MatrixXd &tableau, std::vector<int> &basis, const int &row,
+                                      const int &col) {
+  tableau.row(row) /= tableau(row, col);
+  for (int ri = 0; ri < tableau.rows(); ri++) {
+    if (ri != row && tableau(ri, col) != 0.0) {
+      tableau.row(ri) -= tableau(ri, col) * tableau.row(row);
+    }
+  }
+  basis[row] = col;
+}
+
+bool PolytopeConstraint::intersectBox(const Box &box, const State &src, const State &dst) const {
+  double t_min = 0.0;
+  double t_max = 1.0;
+  for (size_t i = 0; i < getDim(); i++) {
+    const auto dir = dst.vals[i] - src.vals[i];
+    const auto low = box.getLow().vals[i];
+    const auto high = box.getHigh().vals[i];
+    if (dir == 0) {
+      if (src.vals[i] < low || high < src.vals[i]) {
+        return false;
+      }
+      continue;
+    }
+
+    auto t_near = (low - src.vals[i]) / dir;
+    auto t_far = (high - src.vals[i]) / dir;
+    if (dir < 0) {
+      std::swap(t_near, t_far);
+    }
+
+    t_min = std::max(t_min, t_near);
+    t_max = std::min(t_max, t_far);
+    if (t_max < t_min) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool PolytopeConstraint::intersectPolytope(const Polytope &polytope,
+                                           const Eigen::Matrix<double, Eigen::Dynamic, 2> &src_dir) const {
+  // evaluate all half-spaces at once ('A * src' and 'A * dir')
+  const Eigen::Matrix<double, Eigen::Dynamic, 2> prod = polytope.getA() * src_dir;
+  const Eigen::VectorXd &b = polytope.getB();
+
+  // clip the parameter of the segment (0 <= t <= 1) by 'A * src + t * A * dir <= b'
+  double t_min = 0.0;
+  double t_max = 1.0;
+  for (Eigen::Index i = 0; i < prod.rows(); i++) {
+    const auto slack = b(i) - prod(i, 0);
+    if (0 < prod(i, 1)) {
+      t_max = std::min(t_max, slack / prod(i, 1));
+    } else if (prod(i, 1) < 0) {
+      t_min = std::max(t_min, slack / prod(i, 1));
+    } else if (slack < 0) {
+      return false;
+    }
+
+    if (t_max < t_min) {
+      return false;
+    }
+  }
+
+  return true;
+}
+}  // namespace planner
@@ -0,0 +1,208 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Constraint/VoxelConstraint/VoxelConstraint.h>
+
+#include <limits>
+
+namespace planner {
+VoxelConstraint::VoxelConstraint(const EuclideanSpace &space, const double &voxel_size)
+    : base::ConstraintBase(space), voxel_size_(voxel_size) {
+  if (getDim() != 3) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of space must be 3");
+  } else if (!(0.0 < voxel_size)) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Size of voxel is invalid");
+  }
+
+  for (size_t i = 0; i < 3; i++) {
+    auto bound = space.getBound(i + 1);
+    low_[i] = bound.low;
+    size_[i] = std::max<uint32_t>(std::ceil(bound.getRange() / voxel_size_), 1);
+    brick_size_[i] = (size_[i] + BRICK_MASK) >> BRICK_BITS;
+  }
+  clear();
+}
+
+VoxelConstraint::~VoxelConstraint() {}
+
+void VoxelConstraint::clear() { bricks_.assign((size_t)brick_size_[0] * brick_size_[1] * brick_size_[2], 0); }
+
+void VoxelConstraint::setOccupied(const State &state, const bool &occupied) {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  std::array<int32_t, 3> idx;
+  if (!calcVoxelIdx(state, idx)) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State is out of space");
+  }
+  setOccupied(idx[0], idx[1], idx[2], occupied);
+}
+
+void VoxelConstraint::setOccupied(const uint32_t &x, const uint32_t &y, const uint32_t &z, const bool &occupied) {
+  if (size_[0] <= x || size_[1] <= y || size_[2] <= z) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Index is out of range");
+  }
+
+  const std::array<int32_t, 3> idx = {(int32_t)x, (int32_t)y, (int32_t)z};
+  if (occupied) {
+    bricks_[calcBrickIdx(idx)] |= calcBitMask(idx);
+  } else {
+    bricks_[calcBrickIdx(idx)] &= ~calcBitMask(idx);
+  }
+}
+
+bool VoxelConstraint::isOccupied(const uint32_t &x, const uint32_t &y, const uint32_t &z) const {
+  if (size_[0] <= x || size_[1] <= y || size_[2] <= z) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Index is out of range");
+  }
+
+  const std::array<int32_t, 3> idx = {(int32_t)x, (int32_t)y, (int32_t)z};
+  return bricks_[calcBrickIdx(idx)] & calcBitMask(idx);
+}
+
+double VoxelConstraint::getVoxelSize() const { return voxel_size_; }
+
+const std::array<uint32_t, 3> &VoxelConstraint::getSizeRef() const { return size_; }
+
+bool VoxelConstraint::checkCollision(const State &src, const State &dst) const {
+  if (src.getDim() != dst.getDim() || getDim() != src.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  std::array<int32_t, 3> idx;
+  std::array<int32_t, 3> dst_idx;
+  if (!calcVoxelIdx(src, idx) || !calcVoxelIdx(dst, dst_idx)) {
+    return false;
+  }
+
+  // parameter 't' of the segment (src + t * (dst - src)) where it crosses the next voxel boundary on each axis
+  const auto inf = std::numeric_limits<double>::infinity();
+  std::array<int32_t, 3> step;
+  std::array<double, 3> t_max;
+  std::array<double, 3> t_delta;
+  for (size_t i = 0; i < 3; i++) {
+    const auto dir = dst.vals[i] - src.vals[i];
+    if (idx[i] == dst_idx[i]) {
+      // the segment never crosses a boundary on this axis
+      step[i] = 0;
+      t_max[i] = inf;
+      t_delta[i] = inf;
+    } else {
+      step[i] = (0 < dir) ? 1 : -1;
+      const auto boundary = low_[i] + (idx[i] + (0 < dir ? 1 : 0)) * voxel_size_;
+      t_max[i] = (boundary - src.vals[i]) / dir;
+      t_delta[i] = voxel_size_ / std::fabs(dir);
+    }
+  }
+
+  while (true) {
+    const auto brick = bricks_[calcBrickIdx(idx)];
+    if (brick == 0) {
+      // parameter where the segment leaves the brick, which is the boundary after the last voxel in the brick
+      auto t_exit = inf;
+      size_t exit_axis = 0;
+      std::array<uint32_t, 3> num_inner_steps;
+      for (size_t i = 0; i < 3; i++) {
+        num_inner_steps[i] = (0 < step[i]) ? BRICK_MASK - (idx[i] & BRICK_MASK) : (idx[i] & BRICK_MASK);
+        auto t = t_max[i];
+        for (uint32_t j = 0; j < num_inner_steps[i]; j++) {
+          t += t_delta[i];
+        }
+        if (t < t_exit) {
+          t_exit = t;
+          exit_axis = i;
+        }
+      }
+      if (1.0 < t_exit) {
+        return true;
+      }
+
+      // move to the voxel where the segment enters the next brick
+      for (size_t i = 0; i < 3; i++) {
+        const auto num_steps = (i == exit_axis) ? num_inner_steps[i] + 1 : num_inner_steps[i];
+        for (uint32_t j = 0; j < num_steps && (i == exit_axis || t_max[i] < t_exit); j++) {
+          idx[i] += step[i];
+          t_max[i] += t_delta[i];
+        }
+      }
+      if (idx[exit_axis] < 0 || (int32_t)size_[exit_axis] <= idx[exit_axis]) {
+        return true;
+      }
+      continue;
+    }
+
+    if (brick & calcBitMask(idx)) {
+      return false;
+    }
+
+    // move to the next voxel along the segment
+    const size_t axis = (t_max[0] < t_max[1]) ? ((t_max[0] < t_max[2]) ? 0 : 2) : ((t_max[1] < t_max[2]) ? 1 : 2);
+    if (1.0 < t_max[axis]) {
+      return true;
+    }
+    idx[axis] += step[axis];
+    t_max[axis] += t_delta[axis];
+    if (idx[axis] < 0 || (int32_t)size_[axis] <= idx[axis]) {
+      return true;
+    }
+  }
+}
+
+ConstraintType VoxelConstraint::checkConstraintType(const State &state) const {
+  if (getDim() != state.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "State dimension is invalid");
+  }
+
+  std::array<int32_t, 3> idx;
+  if (!calcVoxelIdx(state, idx) || (bricks_[calcBrickIdx(idx)] & calcBitMask(idx))) {
+    return ConstraintType::NOENTRY;
+  }
+  return ConstraintType::ENTAERABLE;
+}
+
+bool VoxelConstraint::calcVoxelIdx(const State &state, std::array<int32_t, 3> &idx) const {
+  for (size_t i = 0; i < 3; i++) {
+    auto bound = space.getBound(i + 1);
+
+    // return false if the state is out of range
+    if (state.vals[i] < bound.low || bound.high < state.vals[i]) {
+      return false;
+    }
+    idx[i] = std::min<int32_t>((state.vals[i] - low_[i]) / voxel_size_, size_[i] - 1);
+  }
+
+  return true;
+}
+
+size_t VoxelConstraint::calcBrickIdx(const std::array<int32_t, 3> &idx) const {
+  return (idx[0] >> BRICK_BITS) +
+         brick_size_[0] * ((idx[1] >> BRICK_BITS) + (size_t)brick_size_[1] * (idx[2] >> BRICK_BITS));
+}
+
+uint64_t VoxelConstraint::calcBitMask(const std::array<int32_t, 3> &idx) {
+  return 1ULL << ((idx[0] & BRICK_MASK) + ((idx[1] & BRICK_MASK) << BRICK_BITS) +
+                  ((idx[2] & BRICK_MASK) << (2 * BRICK_BITS)));
+}
+}  // namespace planner
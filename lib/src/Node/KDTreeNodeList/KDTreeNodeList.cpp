@@ -30,17 +30,14 @@ KDTreeNodeList::KDTreeNodeList(const uint32_t &dim) : base::NodeListBase(dim), r
 KDTreeNodeList::~KDTreeNodeList() {}
 
 void KDTreeNodeList::add(const NodePtr &node) {
-  if (node->parent != nullptr) node->parent->is_leaf = false;
+  if (node->parent != nullptr) {
+    node->parent->is_leaf = false;
+    node->parent->children.push_back(node);
+  }
   nodes_.push_back(node);
 
   if (std::log2(nodes_.size()) * (1 / REBALANCE_RATIO) <= depth_) {
-    // rebuild balanced kd-tree
-    clearRec(root_);
-    root_ = nullptr;
-    depth_ = 0;
-    std::vector<int> indices(nodes_.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    root_ = buildRec(indices, 0, (int)nodes_.size(), 0);
+    rebuild();
   } else {
     // insert the node to kd-tree
     insertRec(root_, nodes_.size() - 1, 0);
@@ -56,6 +53,26 @@ void KDTreeNodeList::init() {
 
 int KDTreeNodeList::getSize() { return nodes_.size(); }
 
+std::vector<KDTreeNodeList::NodePtr> KDTreeNodeList::remove(const std::function<bool(const NodePtr &)> &is_removed) {
+  std::vector<NodePtr> removed_nodes;
+  std::vector<NodePtr> remaining_nodes;
+  for (const auto &v : nodes_) {
+    if (is_removed(v)) {
+      removed_nodes.push_back(v);
+    } else {
+      remaining_nodes.push_back(v);
+    }
+  }
+  if (removed_nodes.empty()) {
+    return removed_nodes;
+  }
+
+  // rebuild balanced kd-tree of remaining nodes
+  nodes_.swap(remaining_nodes);
+  rebuild();
+  return removed_nodes;
+}
+
 KDTreeNodeList::NodePtr KDTreeNodeList::searchNN(const NodePtr &node) {
   NodePtr ret_node;
   auto min_dist = std::numeric_limits<double>::max();
@@ -79,6 +96,15 @@ std::vector<KDTreeNodeList::NodePtr> KDTreeNodeList::searchLeafs() {
   return ret_nodes;
 }
 
+void KDTreeNodeList::rebuild() {
+  clearRec(root_);
+  root_ = nullptr;
+  depth_ = 0;
+  std::vector<int> indices(nodes_.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  root_ = buildRec(indices, 0, (int)nodes_.size(), 0);
+}
+
 void KDTreeNodeList::clearRec(const KDNodePtr &node) {
   if (node == nullptr) return;
   if (node->child_r) {
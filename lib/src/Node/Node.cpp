@@ -26,6 +26,10 @@
 
 namespace planner {
 Node::Node(const State &_state, const std::shared_ptr<Node> _parent, const double &_cost, const double &_cost_to_goal)
-    : state(_state), parent(_parent), cost(_cost), cost_to_goal(_cost_to_goal), is_leaf(true) {}
+    : state(_state), parent(_parent), cost(_cost), cost_to_goal(_cost_to_goal), is_leaf(true),
+      is_edge_checked(true),
+      is_valid(false),
+      clearance(-1.0),
+      id(std::numeric_limits<uint32_t>::max()) {}
 Node::~Node() {}
 }  // namespace planner
@@ -30,12 +30,29 @@ SimpleNodeList::SimpleNodeList(const uint32_t &dim) : base::NodeListBase(dim), l
 SimpleNodeList::~SimpleNodeList() {}
 
 void SimpleNodeList::add(const NodePtr &node) {
-  if (node->parent != nullptr) node->parent->is_leaf = false;
+  if (node->parent != nullptr) {
+    node->parent->is_leaf = false;
+    node->parent->children.push_back(node);
+  }
   list_.push_back(node);
 }
 
 void SimpleNodeList::init() { list_.clear(); }
 
+std::vector<SimpleNodeList::NodePtr> SimpleNodeList::remove(const std::function<bool(const NodePtr &)> &is_removed) {
+  std::vector<NodePtr> removed_nodes;
+  std::vector<NodePtr> remaining_nodes;
+  for (const auto &v : list_) {
+    if (is_removed(v)) {
+      removed_nodes.push_back(v);
+    } else {
+      remaining_nodes.push_back(v);
+    }
+  }
+  list_.swap(remaining_nodes);
+  return removed_nodes;
+}
+
 int SimpleNodeList::getSize() { return list_.size(); }
 
 SimpleNodeList::NodePtr SimpleNodeList::searchNN(const NodePtr &node) {
@@ -0,0 +1,133 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Planner/EdgeCollisionCache/EdgeCollisionCache.h>
+
+#include <algorithm>
+
+namespace planner {
+constexpr uint64_t EdgeCollisionCache::EMPTY;
+constexpr uint32_t EdgeCollisionCache::MAX_ID;
+
+EdgeCollisionCache::EdgeCollisionCache(const size_t &initial_capacity) : size_(0), num_hits_(0), num_misses_(0) {
+  // capacity is power of two so that the hash is masked
+  size_t capacity = 16;
+  while (capacity < initial_capacity) {
+    capacity *= 2;
+  }
+  table_.assign(capacity, EMPTY);
+}
+
+EdgeCollisionCache::~EdgeCollisionCache() {}
+
+void EdgeCollisionCache::clear() {
+  std::fill(table_.begin(), table_.end(), EMPTY);
+  size_ = 0;
+  num_hits_ = 0;
+  num_misses_ = 0;
+}
+
+bool EdgeCollisionCache::find(const uint32_t &id1, const uint32_t &id2, bool &is_free) {
+  if (MAX_ID < id1 || MAX_ID < id2) {
+    num_misses_++;
+    return false;
+  }
+
+  const auto key = calcKey(id1, id2);
+  const auto mask = table_.size() - 1;
+  for (auto i = calcHash(key) & mask;; i = (i + 1) & mask) {
+    if (table_[i] == EMPTY) {
+      num_misses_++;
+      return false;
+    } else if ((table_[i] >> 1) == key) {
+      is_free = table_[i] & 1;
+      num_hits_++;
+      return true;
+    }
+  }
+}
+
+void EdgeCollisionCache::insert(const uint32_t &id1, const uint32_t &id2, const bool &is_free) {
+  if (MAX_ID < id1 || MAX_ID < id2) {
+    return;
+  }
+
+  if (MAX_LOAD_FACTOR * table_.size() <= size_ + 1) {
+    rehash(2 * table_.size());
+  }
+
+  const auto key = calcKey(id1, id2);
+  const auto entry = (key << 1) | (is_free ? 1 : 0);
+  const auto mask = table_.size() - 1;
+  for (auto i = calcHash(key) & mask;; i = (i + 1) & mask) {
+    if (table_[i] == EMPTY) {
+      table_[i] = entry;
+      size_++;
+      return;
+    } else if ((table_[i] >> 1) == key) {
+      table_[i] = entry;
+      return;
+    }
+  }
+}
+
+size_t EdgeCollisionCache::getSize() const { return size_; }
+
+uint64_t EdgeCollisionCache::getNumHits() const { return num_hits_; }
+
+uint64_t EdgeCollisionCache::getNumMisses() const { return num_misses_; }
+
+double EdgeCollisionCache::getHitRate() const {
+  const auto num_queries = num_hits_ + num_misses_;
+  return (num_queries == 0) ? 0.0 : (double)num_hits_ / num_queries;
+}
+
+uint64_t EdgeCollisionCache::calcKey(const uint32_t &id1, const uint32_t &id2) {
+  return ((uint64_t)std::min(id1, id2) << 31) | std::max(id1, id2);
+}
+
+uint64_t EdgeCollisionCache::calcHash(uint64_t key) {
+  // finalizer of splitmix64
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+void EdgeCollisionCache::rehash(const size_t &capacity) {
+  std::vector<uint64_t> old_table(capacity, EMPTY);
+  old_table.swap(table_);
+
+  const auto mask = table_.size() - 1;
+  for (const auto &entry : old_table) {
+    if (entry == EMPTY) {
+      continue;
+    }
+    auto i = calcHash(entry >> 1) & mask;
+    while (table_[i] != EMPTY) {
+      i = (i + 1) & mask;
+    }
+    table_[i] = entry;
+  }
+}
+}  // namespace planner
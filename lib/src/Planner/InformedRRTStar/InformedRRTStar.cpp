@@ -32,7 +32,8 @@ InformedRRTStar::InformedRRTStar(const uint32_t &dim, const uint32_t &max_sampli
       max_sampling_num_(max_sampling_num),
       expand_dist_(expand_dist),
       R_(R),
-      goal_region_radius_(goal_region_radius) {
+      goal_region_radius_(goal_region_radius),
+      prune_threshold_(0.05) {
   setGoalSamplingRate(goal_sampling_rate);
 }
 
@@ -57,24 +58,37 @@ void InformedRRTStar::setGoalRegionRadius(const double &goal_region_radius) {
   goal_region_radius_ = goal_region_radius;
 }
 
+void InformedRRTStar::setPruneThreshold(const double &prune_threshold) {
+  if (!(0.0 <= prune_threshold)) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Threshold of pruning is invalid");
+  }
+
+  prune_threshold_ = prune_threshold;
+}
+
 bool InformedRRTStar::solve(const State &start, const State &goal) {
-  auto estimate_cost = [](const std::shared_ptr<Node> &node) -> double { return node->cost + node->cost_to_goal; };
+  // cost of the path through the node (cost_to_goal is only a lower bound when the edge cost is not the distance)
+  auto estimate_cost = [&](const std::shared_ptr<Node> &node) -> double {
+    return node->cost + constraint_->calcEdgeCost(node->state, goal);
+  };
 
   // initialize sampler and node list
   sampler_->applyStartAndGoal(start, goal);
-  node_list_->init();
-  node_list_->add(std::make_shared<Node>(start, nullptr));
+  initPlanning(start);
+  auto goal_node = createNode(goal, nullptr);
 
   // sampling on euclidean space
   std::shared_ptr<Node> min_cost_node = nullptr;
-  for (size_t i = 0; i < max_sampling_num_; i++) {
+  auto best_cost = std::numeric_limits<double>::max();
+  auto pruned_cost = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < max_sampling_num_ && !isTimeOver(); i++) {
     // sampling node
     auto rand_node = std::make_shared<Node>(goal, nullptr, 0);
     if (goal_sampling_rate_ < sampler_->getUniformUnitRandomVal()) {
       if (min_cost_node == nullptr) {
         rand_node->state = sampler_->run(Sampler::Mode::WholeArea);
       } else {
-        sampler_->setBestCost(min_cost_node->cost + goal.distanceFrom(min_cost_node->state));
+        sampler_->setBestCost(best_cost);
         rand_node->state = sampler_->run(Sampler::Mode::HeuristicDomain);
       }
 
@@ -82,6 +96,7 @@ bool InformedRRTStar::solve(const State &start, const State &goal) {
       if (constraint_->checkConstraintType(rand_node->state) == ConstraintType::NOENTRY) {
         continue;
       }
+      rand_node->is_valid = true;
     }
 
     // get node that is nearest neighbor node from node list and generate new
@@ -90,8 +105,15 @@ bool InformedRRTStar::solve(const State &start, const State &goal) {
     auto new_node = generateSteerNode(nearest_node, rand_node, expand_dist_);
     new_node->cost_to_goal = new_node->state.distanceFrom(goal);
 
+    // reject new node which cannot be on a better path before collision check
+    // (a sample in the heuristic domain can be steered out of it from a nearest node outside it)
+    if (!canImprove(start, goal, new_node->state, best_cost)) {
+      statistics_.num_rejected_nodes++;
+      continue;
+    }
+
     // add to list if new node meets constraint
-    if (constraint_->checkCollision(nearest_node->state, new_node->state)) {
+    if (checkCollision(nearest_node, new_node)) {
       // find nodes that exist on certain domain
       auto nof_node = node_list_->getSize();
       auto radius =
@@ -112,38 +134,42 @@ bool InformedRRTStar::solve(const State &start, const State &goal) {
       for (const auto &changed_cost_node : changed_cost_nodes) {
         if (changed_cost_node->cost_to_goal <= goal_region_radius_) {
           if (min_cost_node == nullptr || estimate_cost(changed_cost_node) < estimate_cost(min_cost_node)) {
-            if (constraint_->checkCollision(goal, changed_cost_node->state)) {
+            if (checkCollision(goal_node, changed_cost_node)) {
               min_cost_node = changed_cost_node;
             }
           }
         }
       }
 
-      if (min_cost_node != nullptr && estimate_cost(min_cost_node) < terminate_search_cost_) {
+      if (min_cost_node == nullptr) {
+        continue;
+      }
+      const auto cost = estimate_cost(min_cost_node);
+      if (cost < best_cost) {
+        notifyImprovement(min_cost_node, goal, cost);
+      }
+      best_cost = cost;
+      if (best_cost < terminate_search_cost_) {
         break;
       }
+
+      // remove nodes which cannot be on a better path with their descendants
+      // (edge cost is not less than the distance, so that descendants cannot be on a better path either)
+      if (best_cost < pruned_cost * (1.0 - prune_threshold_)) {
+        statistics_.num_pruned_nodes += removeNodes([&](const std::shared_ptr<Node> &node) {
+          return best_cost < node->cost + node->state.distanceFrom(goal);
+        });
+        pruned_cost = best_cost;
+      }
     }
   }
 
   // store the result
-  result_.clear();
   if (min_cost_node == nullptr) {
     return false;
   } else {
-    auto result_node = min_cost_node;
-    result_cost_ = estimate_cost(result_node);
-    if (result_node->state != goal) {
-      result_.push_back(goal);
-    }
-
-    while (true) {
-      result_.insert(result_.begin(), result_node->state);
-      if (result_node->parent == nullptr) {
-        break;
-      }
-
-      result_node = result_node->parent;
-    }
+    result_cost_ = estimate_cost(min_cost_node);
+    storeResult(min_cost_node, goal);
     return true;
   }
 }
@@ -24,12 +24,29 @@
 
 #include <Planner/PlannerBase.h>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace planner {
 namespace base {
 PlannerBase::PlannerBase(const uint32_t &dim, std::shared_ptr<NodeListBase> node_list)
     : terminate_search_cost_(0),
       constraint_(std::make_shared<ConstraintBase>(EuclideanSpace(dim))),
-      node_list_(node_list) {}
+      node_list_(node_list),
+      result_goal_(dim),
+      use_clearance_(true),
+      use_collision_cache_(false),
+      next_node_id_(0),
+      time_budget_(Clock::duration::max()),
+      deadline_(Clock::time_point::max()),
+      time_budget_check_interval_(1),
+      deadline_check_interval_(1),
+      time_check_interval_(1),
+      time_check_count_(0),
+      solve_deadline_(Clock::time_point::max()) {}
 
 PlannerBase::~PlannerBase() {}
 
@@ -45,61 +62,461 @@ void PlannerBase::setTerminateSearchCost(const double &terminate_search_cost) {
   terminate_search_cost_ = terminate_search_cost;
 }
 
-const std::vector<State> &PlannerBase::getResult() const { return result_; }
+void PlannerBase::setUseCollisionCache(const bool &use_collision_cache) { use_collision_cache_ = use_collision_cache; }
+
+const EdgeCollisionCache &PlannerBase::getCollisionCache() const { return collision_cache_; }
+
+void PlannerBase::setUseClearance(const bool &use_clearance) { use_clearance_ = use_clearance; }
+
+void PlannerBase::setNumThreads(const uint32_t &num_threads) {
+  const auto num = (num_threads == 0) ? std::max<uint32_t>(std::thread::hardware_concurrency(), 1) : num_threads;
+  thread_pool_ = (num == 1) ? nullptr : std::make_shared<ThreadPool>(num);
+}
+
+void PlannerBase::setThreadPool(const std::shared_ptr<ThreadPool> &thread_pool) { thread_pool_ = thread_pool; }
+
+uint32_t PlannerBase::getNumThreads() const { return (thread_pool_ == nullptr) ? 1 : thread_pool_->getNumThreads(); }
+
+void PlannerBase::setTimeBudget(const Clock::duration &time_budget, const uint32_t &check_interval) {
+  if (check_interval == 0) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Check interval is invalid");
+  }
+  time_budget_ = time_budget;
+  time_budget_check_interval_ = check_interval;
+}
+
+void PlannerBase::setDeadline(const Clock::time_point &deadline, const uint32_t &check_interval) {
+  if (check_interval == 0) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Check interval is invalid");
+  }
+  deadline_ = deadline;
+  deadline_check_interval_ = check_interval;
+}
+
+void PlannerBase::setImprovementCallback(const ImprovementCallback &callback) { improvement_callback_ = callback; }
+
+const PlannerStatistics &PlannerBase::getStatistics() const { return statistics_; }
+
+const std::vector<State> &PlannerBase::getResult() const {
+  if (result_.size() != result_view_.size()) {
+    result_.clear();
+    result_.reserve(result_view_.size());
+    for (const auto &state : result_view_) {
+      result_.push_back(*state);
+    }
+  }
+  return result_;
+}
+
+const std::vector<const State *> &PlannerBase::getResultView() const { return result_view_; }
 
 double PlannerBase::getResultCost() const { return result_cost_; }
 
 std::shared_ptr<NodeListBase> PlannerBase::getNodeList() const { return node_list_; }
 
+std::shared_ptr<Node> PlannerBase::initPlanning(const State &start) {
+  node_list_->init();
+  collision_cache_.clear();
+  statistics_.reset();
+  result_.clear();
+  result_view_.clear();
+  result_cost_ = std::numeric_limits<double>::max();
+  next_node_id_ = 0;
+
+  // deadline of this planning (the earlier of the deadline and the end of the time budget)
+  // and interval of checks (the shorter one of them which are set)
+  time_check_count_ = 0;
+  time_check_interval_ = std::numeric_limits<uint32_t>::max();
+  solve_deadline_ = deadline_;
+  if (deadline_ != Clock::time_point::max()) {
+    time_check_interval_ = deadline_check_interval_;
+  }
+  if (time_budget_ != Clock::duration::max()) {
+    solve_deadline_ = std::min(solve_deadline_, Clock::now() + time_budget_);
+    time_check_interval_ = std::min(time_check_interval_, time_budget_check_interval_);
+  }
+
+  auto start_node = createNode(start, nullptr);
+  node_list_->add(start_node);
+  return start_node;
+}
+
+bool PlannerBase::isTimeOver() {
+  if (solve_deadline_ == Clock::time_point::max() || ++time_check_count_ % time_check_interval_ != 0) {
+    return false;
+  }
+  return solve_deadline_ <= Clock::now();
+}
+
+void PlannerBase::notifyImprovement(const std::shared_ptr<Node> &node, const State &goal, const double &cost) {
+  if (!improvement_callback_) {
+    return;
+  }
+
+  result_cost_ = cost;
+  storeResult(node, goal);
+  improvement_callback_(getResult(), cost);
+}
+
+void PlannerBase::storeResult(const std::shared_ptr<Node> &node, const State &goal) {
+  // walk toward start node once and reverse the order
+  result_.clear();
+  result_view_.clear();
+  for (auto target = node.get(); target != nullptr; target = target->parent.get()) {
+    result_view_.push_back(&target->state);
+  }
+  std::reverse(result_view_.begin(), result_view_.end());
+
+  if (node->state != goal) {
+    result_goal_ = goal;
+    result_view_.push_back(&result_goal_);
+  }
+}
+
+std::shared_ptr<Node> PlannerBase::createNode(const State &state, const std::shared_ptr<Node> &parent,
+                                              const double &cost) {
+  auto node = std::make_shared<Node>(state, parent, cost);
+  node->id = next_node_id_++;
+  return node;
+}
+
+bool PlannerBase::canImprove(const State &start, const State &goal, const State &state, const double &best_cost) {
+  return start.distanceFrom(state) + state.distanceFrom(goal) < best_cost;
+}
+
+double PlannerBase::getClearance(const std::shared_ptr<Node> &node) const {
+  if (node->clearance < 0.0) {
+    node->clearance = constraint_->clearance(node->state);
+  }
+  return node->clearance;
+}
+
+bool PlannerBase::isInClearance(const std::shared_ptr<Node> &src, const std::shared_ptr<Node> &dst) const {
+  if (!use_clearance_) {
+    return false;
+  }
+
+  const auto dist = src->state.distanceFrom(dst->state);
+  return dist < getClearance(src) || dist < getClearance(dst);
+}
+
+bool PlannerBase::checkCollision(const std::shared_ptr<Node> &src, const std::shared_ptr<Node> &dst) {
+  bool is_free;
+  if (isInClearance(src, dst)) {
+    is_free = true;
+    statistics_.num_clearance_skips++;
+  } else if (!use_collision_cache_ || !collision_cache_.find(src->id, dst->id, is_free)) {
+    statistics_.num_collision_checks++;
+    // the end which is known to meet constraint is not checked again
+    if (src->is_valid) {
+      is_free = constraint_->checkCollisionFromValidState(src->state, dst->state);
+    } else if (dst->is_valid) {
+      is_free = constraint_->checkCollisionFromValidState(dst->state, src->state);
+    } else {
+      is_free = constraint_->checkCollision(src->state, dst->state);
+    }
+
+    if (use_collision_cache_) {
+      collision_cache_.insert(src->id, dst->id, is_free);
+    }
+  }
+
+  if (is_free) {
+    src->is_valid = true;
+    dst->is_valid = true;
+  }
+  return is_free;
+}
+
+void PlannerBase::checkCollisionBatch(const std::shared_ptr<Node> &src, const std::vector<std::shared_ptr<Node>> &dsts,
+                                      std::vector<bool> &results) {
+  results.resize(dsts.size());
+
+  // edges which are not found in the cache
+  std::vector<size_t> unknown_indices;
+  std::vector<State> unknown_states;
+  for (size_t i = 0; i < dsts.size(); i++) {
+    bool is_free;
+    if (isInClearance(src, dsts[i])) {
+      results[i] = true;
+      src->is_valid = true;
+      statistics_.num_clearance_skips++;
+    } else if (use_collision_cache_ && collision_cache_.find(src->id, dsts[i]->id, is_free)) {
+      results[i] = is_free;
+    } else {
+      unknown_indices.push_back(i);
+      unknown_states.push_back(dsts[i]->state);
+    }
+  }
+  if (unknown_indices.empty()) {
+    return;
+  }
+  statistics_.num_collision_checks += unknown_indices.size();
+
+  std::vector<bool> unknown_results;
+  if (getNumThreads() == 1 || unknown_states.size() == 1) {
+    constraint_->checkCollisionBatch(src->state, unknown_states, unknown_results);
+  } else {
+    // contiguous chunks are checked in parallel so that batch checks of constraint are still used
+    // (results are written to bytes because each element of std::vector<bool> is not a separate object)
+    const auto num_chunks = std::min<size_t>(unknown_states.size(), getNumThreads() * CHUNKS_PER_THREAD);
+    const auto chunk_size = (unknown_states.size() + num_chunks - 1) / num_chunks;
+    std::vector<uint8_t> chunk_results(unknown_states.size());
+    thread_pool_->parallelFor(num_chunks, [&](const size_t &chunk) {
+      const auto begin = std::min(chunk * chunk_size, unknown_states.size());
+      const auto end = std::min(begin + chunk_size, unknown_states.size());
+      if (begin == end) {
+        return;
+      }
+
+      std::vector<State> states(unknown_states.begin() + begin, unknown_states.begin() + end);
+      std::vector<bool> results;
+      constraint_->checkCollisionBatch(src->state, states, results);
+      std::copy(results.begin(), results.end(), chunk_results.begin() + begin);
+    });
+    unknown_results.assign(chunk_results.begin(), chunk_results.end());
+  }
+  for (size_t i = 0; i < unknown_indices.size(); i++) {
+    const auto &dst = dsts[unknown_indices[i]];
+    results[unknown_indices[i]] = unknown_results[i];
+    if (use_collision_cache_) {
+      collision_cache_.insert(src->id, dst->id, unknown_results[i]);
+    }
+    if (unknown_results[i]) {
+      src->is_valid = true;
+      dst->is_valid = true;
+    }
+  }
+}
+
 std::shared_ptr<Node> PlannerBase::generateSteerNode(const std::shared_ptr<Node> &src_node,
                                                      const std::shared_ptr<Node> &dst_node,
-                                                     const double &expand_dist) const {
-  auto steered_node = std::make_shared<Node>(src_node->state, src_node, src_node->cost);
+                                                     const double &expand_dist) {
+  auto steered_node = createNode(src_node->state, src_node, src_node->cost);
   auto dist_src_to_dst = src_node->state.distanceFrom(dst_node->state);
   if (dist_src_to_dst < expand_dist) {
-    steered_node->cost += dist_src_to_dst;
     steered_node->state = dst_node->state;
+    steered_node->is_valid = dst_node->is_valid;
   } else {
-    steered_node->cost += expand_dist;
     steered_node->state = src_node->state + ((dst_node->state - src_node->state) / dist_src_to_dst) * expand_dist;
   }
+  steered_node->cost += constraint_->calcEdgeCost(src_node->state, steered_node->state);
   return steered_node;
 }
 
+void PlannerBase::changeParent(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &parent,
+                               const double &cost, std::vector<std::shared_ptr<Node>> &changed_nodes) {
+  if (node->parent != parent) {
+    unlinkFromParent(node);
+    parent->children.push_back(node);
+    parent->is_leaf = false;
+    node->parent = parent;
+  }
+
+  const auto is_prev_cost_known = node->cost != std::numeric_limits<double>::max();
+  const auto diff = cost - node->cost;
+  node->cost = cost;
+  changed_nodes.push_back(node);
+
+  // traverse the subtree iteratively
+  std::vector<std::shared_ptr<Node>> stack{node};
+  while (!stack.empty()) {
+    const auto target = stack.back();
+    stack.pop_back();
+    for (const auto &child_ptr : target->children) {
+      auto child = child_ptr.lock();
+      // (an unreachable child is skipped unless the whole subtree was unreachable with the node)
+      if (child == nullptr || (is_prev_cost_known && child->cost == std::numeric_limits<double>::max())) {
+        continue;
+      }
+
+      if (is_prev_cost_known) {
+        child->cost += diff;
+      } else {
+        child->cost = target->cost + constraint_->calcEdgeCost(target->state, child->state);
+      }
+      changed_nodes.push_back(child);
+      stack.push_back(child);
+    }
+  }
+}
+
+size_t PlannerBase::removeNodes(const std::function<bool(const std::shared_ptr<Node> &)> &is_removed) {
+  // whether the node or one of its ancestors satisfies the condition
+  // (results of ancestors are memorized, so that each node is evaluated once)
+  std::unordered_map<const Node *, bool> is_removed_subtree;
+  std::vector<const Node *> path;
+  const auto removed_nodes = node_list_->remove([&](const std::shared_ptr<Node> &node) {
+    path.clear();
+    auto result = false;
+    for (auto target = node; target != nullptr; target = target->parent) {
+      const auto itr = is_removed_subtree.find(target.get());
+      if (itr != is_removed_subtree.end()) {
+        result = itr->second;
+        break;
+      }
+      path.push_back(target.get());
+      if (is_removed(target)) {
+        result = true;
+        break;
+      }
+    }
+    for (const auto &path_node : path) {
+      is_removed_subtree[path_node] = result;
+    }
+    return result;
+  });
+  for (const auto &node : removed_nodes) {
+    unlinkFromParent(node);
+  }
+  return removed_nodes.size();
+}
+
+void PlannerBase::unlinkFromParent(const std::shared_ptr<Node> &node) {
+  if (node->parent == nullptr) {
+    return;
+  }
+
+  auto &siblings = node->parent->children;
+  for (auto itr = siblings.begin(); itr != siblings.end(); itr++) {
+    if (itr->lock() == node) {
+      *itr = siblings.back();
+      siblings.pop_back();
+      break;
+    }
+  }
+  node->parent->is_leaf = siblings.empty();
+}
+
 void PlannerBase::updateParent(const std::shared_ptr<Node> &target_node,
-                               const std::vector<std::shared_ptr<Node>> &near_nodes) const {
-  auto min_cost_parent_node = target_node->parent;
-  auto min_cost = std::numeric_limits<double>::max();
+                               const std::vector<std::shared_ptr<Node>> &near_nodes, const bool &lazy) {
+  // near nodes which are cheaper than current parent (the edge from current parent is already valid)
+  std::vector<std::shared_ptr<Node>> near_candidate_nodes;
+  std::vector<double> near_candidate_costs;
+  // (edge cost is not less than the distance, so it is calculated only if the distance can improve the cost)
+  statistics_.num_near_nodes += near_nodes.size();
   for (const auto &near_node : near_nodes) {
-    auto dist = target_node->state.distanceFrom(near_node->state);
-    auto cost = near_node->cost + dist;
-    if (cost < min_cost) {
-      if (constraint_->checkCollision(target_node->state, near_node->state)) {
-        min_cost_parent_node = near_node;
-        min_cost = cost;
+    if (near_node->cost == std::numeric_limits<double>::max() ||
+        target_node->cost <= near_node->cost + near_node->state.distanceFrom(target_node->state) ||
+        near_node == target_node->parent) {
+      statistics_.num_skipped_candidates++;
+      continue;
+    }
+    auto cost = near_node->cost + constraint_->calcEdgeCost(near_node->state, target_node->state);
+    if (cost < target_node->cost) {
+      near_candidate_nodes.push_back(near_node);
+      near_candidate_costs.push_back(cost);
+    } else {
+      statistics_.num_skipped_candidates++;
+    }
+  }
+  if (near_candidate_nodes.empty()) {
+    return;
+  }
+
+  // candidates in ascending order of cost
+  std::vector<size_t> order(near_candidate_nodes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](const size_t &lhs, const size_t &rhs) {
+    return near_candidate_costs[lhs] < near_candidate_costs[rhs];
+  });
+  std::vector<std::shared_ptr<Node>> candidate_nodes(order.size());
+  std::vector<double> candidate_costs(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    candidate_nodes[i] = near_candidate_nodes[order[i]];
+    candidate_costs[i] = near_candidate_costs[order[i]];
+  }
+
+  // the first valid candidate is the cheapest one, so that the following candidates are not checked
+  // (with several threads, candidates are checked in waves of the number of threads)
+  const size_t wave_size = getNumThreads();
+  auto min_cost_parent_node = target_node->parent;
+  auto min_cost = target_node->cost;
+  for (size_t begin = 0; begin < candidate_nodes.size() && min_cost_parent_node == target_node->parent;
+       begin += wave_size) {
+    const auto end = std::min(begin + wave_size, candidate_nodes.size());
+    std::vector<std::shared_ptr<Node>> wave_nodes(candidate_nodes.begin() + begin, candidate_nodes.begin() + end);
+    std::vector<bool> results(wave_nodes.size(), true);
+    if (!lazy && wave_nodes.size() == 1) {
+      results[0] = checkCollision(target_node, wave_nodes[0]);
+    } else if (!lazy) {
+      checkCollisionBatch(target_node, wave_nodes, results);
+    }
+
+    for (size_t i = 0; i < wave_nodes.size(); i++) {
+      if (results[i]) {
+        min_cost_parent_node = wave_nodes[i];
+        min_cost = candidate_costs[begin + i];
+        break;
       }
     }
   }
-  if (min_cost != std::numeric_limits<double>::max()) {
+  if (min_cost_parent_node != target_node->parent) {
     target_node->parent = min_cost_parent_node;
     target_node->cost = min_cost;
+    target_node->is_edge_checked = !lazy;
   }
 }
 
 std::vector<std::shared_ptr<Node>> PlannerBase::rewireNearNodes(std::shared_ptr<Node> &new_node,
-                                                                std::vector<std::shared_ptr<Node>> &near_nodes) const {
-  std::vector<std::shared_ptr<Node>> rewired_nodes;
+                                                                std::vector<std::shared_ptr<Node>> &near_nodes,
+                                                                const bool &lazy) {
+  // near nodes which become cheaper through new node
+  std::vector<std::shared_ptr<Node>> candidate_nodes;
+  std::vector<double> candidate_costs;
+  statistics_.num_near_nodes += near_nodes.size();
+  // (unreachable nodes are not rewired)
   for (const auto &near_node : near_nodes) {
-    auto new_cost = new_node->cost + near_node->state.distanceFrom(new_node->state);
+    if (near_node->cost == std::numeric_limits<double>::max() ||
+        near_node->cost <= new_node->cost + new_node->state.distanceFrom(near_node->state)) {
+      statistics_.num_skipped_candidates++;
+      continue;
+    }
+    auto new_cost = new_node->cost + constraint_->calcEdgeCost(new_node->state, near_node->state);
     if (new_cost < near_node->cost) {
-      if (constraint_->checkCollision(new_node->state, near_node->state)) {
-        near_node->parent = new_node;
-        near_node->cost = new_cost;
-        rewired_nodes.push_back(near_node);
+      candidate_nodes.push_back(near_node);
+      candidate_costs.push_back(new_cost);
+    } else {
+      statistics_.num_skipped_candidates++;
+    }
+  }
+
+  // an ancestor of new node cannot become its child
+  // (costs along the path from start may be stale until lazy collision checking repairs them)
+  if (!candidate_nodes.empty()) {
+    std::unordered_set<const Node *> ancestors;
+    for (auto ancestor = new_node->parent; ancestor != nullptr; ancestor = ancestor->parent) {
+      ancestors.insert(ancestor.get());
+    }
+    size_t num_candidates = 0;
+    for (size_t i = 0; i < candidate_nodes.size(); i++) {
+      if (ancestors.count(candidate_nodes[i].get()) == 0) {
+        candidate_nodes[num_candidates] = candidate_nodes[i];
+        candidate_costs[num_candidates] = candidate_costs[i];
+        num_candidates++;
+      } else {
+        statistics_.num_skipped_candidates++;
       }
     }
+    candidate_nodes.resize(num_candidates);
+    candidate_costs.resize(num_candidates);
+  }
+
+  std::vector<bool> results(candidate_nodes.size(), true);
+  if (!lazy && !candidate_nodes.empty()) {
+    checkCollisionBatch(new_node, candidate_nodes, results);
+  }
+
+  std::vector<std::shared_ptr<Node>> changed_nodes;
+  for (size_t i = 0; i < candidate_nodes.size(); i++) {
+    // an earlier rewire may have already lowered the cost of a descendant candidate
+    // (edge costs do not always meet the triangle inequality)
+    if (results[i] && candidate_costs[i] < candidate_nodes[i]->cost) {
+      changeParent(candidate_nodes[i], new_node, candidate_costs[i], changed_nodes);
+      candidate_nodes[i]->is_edge_checked = !lazy;
+    }
   }
-  return rewired_nodes;
+  return changed_nodes;
 }
 }  // namespace base
 }  // namespace planner
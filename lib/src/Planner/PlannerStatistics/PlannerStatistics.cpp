@@ -0,0 +1,47 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Planner/PlannerStatistics/PlannerStatistics.h>
+
+namespace planner {
+PlannerStatistics::PlannerStatistics() { reset(); }
+
+void PlannerStatistics::reset() {
+  num_near_nodes = 0;
+  num_skipped_candidates = 0;
+  num_clearance_skips = 0;
+  num_collision_checks = 0;
+  num_pruned_nodes = 0;
+  num_rejected_samples = 0;
+  num_rejected_nodes = 0;
+}
+
+std::ostream &operator<<(std::ostream &os, const PlannerStatistics &obj) {
+  os << "near nodes: " << obj.num_near_nodes << ", skipped candidates: " << obj.num_skipped_candidates
+     << ", clearance skips: " << obj.num_clearance_skips << ", collision checks: " << obj.num_collision_checks
+     << ", pruned nodes: " << obj.num_pruned_nodes << ", rejected samples: " << obj.num_rejected_samples
+     << ", rejected nodes: " << obj.num_rejected_nodes;
+  return os;
+}
+}  // namespace planner
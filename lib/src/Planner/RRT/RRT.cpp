@@ -50,13 +50,16 @@ void RRT::setExpandDist(double expand_dist) noexcept { expand_dist_ = expand_dis
 
 bool RRT::solve(const State &start, const State &goal) {
   // initialize list of node
-  node_list_->init();
-  node_list_->add(std::make_shared<Node>(start, nullptr));
+  initPlanning(start);
 
   // sampling on euclidean space
   uint32_t sampling_cnt = 0;
   std::shared_ptr<Node> end_node;
   while (true) {
+    if (isTimeOver()) {
+      return false;
+    }
+
     auto rand_node = std::make_shared<Node>(goal, nullptr);
     if (goal_sampling_rate_ < sampler_->getUniformUnitRandomVal()) {
       rand_node->state = sampler_->run(Sampler::Mode::WholeArea);
@@ -65,6 +68,7 @@ bool RRT::solve(const State &start, const State &goal) {
       if (constraint_->checkConstraintType(rand_node->state) == ConstraintType::NOENTRY) {
         continue;
       }
+      rand_node->is_valid = true;
     }
 
     // get index of node that nearest node from sampling node
@@ -74,14 +78,15 @@ bool RRT::solve(const State &start, const State &goal) {
     auto new_node = generateSteerNode(nearest_node, rand_node, expand_dist_);
 
     // add to list if new node meets constraint
-    if (constraint_->checkCollision(nearest_node->state, new_node->state)) {
+    if (checkCollision(nearest_node, new_node)) {
       node_list_->add(new_node);
 
       // terminate processing if distance between new node and goal state is
       // less than 'expand_dist'
       if (new_node->state.distanceFrom(goal) <= expand_dist_) {
-        end_node = std::make_shared<Node>(goal, new_node);
+        end_node = createNode(goal, new_node, new_node->cost + constraint_->calcEdgeCost(new_node->state, goal));
         node_list_->add(end_node);
+        notifyImprovement(end_node, goal, end_node->cost);
         break;
       }
     }
@@ -93,21 +98,8 @@ bool RRT::solve(const State &start, const State &goal) {
   }
 
   // store the result
-  result_.clear();
-  auto cost = 0.0;
-  while (true) {
-    result_.insert(result_.begin(), end_node->state);
-    if (end_node->parent == nullptr) {
-      cost += end_node->state.distanceFrom(start);
-      break;
-    } else {
-      cost += end_node->state.distanceFrom(end_node->parent->state);
-    }
-
-    end_node = end_node->parent;
-  }
-
-  result_cost_ = cost;
+  result_cost_ = end_node->cost;
+  storeResult(end_node, goal);
   return true;
 }
 }  // namespace planner
@@ -30,7 +30,9 @@ RRTStar::RRTStar(const uint32_t &dim, const uint32_t &max_sampling_num, const do
     : base::PlannerBase(dim, std::make_shared<KDTreeNodeList>(dim)),
       max_sampling_num_(max_sampling_num),
       expand_dist_(expand_dist),
-      R_(R) {
+      R_(R),
+      lazy_collision_check_(false),
+      has_unreachable_nodes_(false) {
   setGoalSamplingRate(goal_sampling_rate);
 }
 
@@ -51,87 +53,225 @@ void RRTStar::setExpandDist(const double &expand_dist) { expand_dist_ = expand_d
 
 void RRTStar::setR(const double &R) { R_ = R; }
 
+void RRTStar::setLazyCollisionCheck(const bool &lazy_collision_check) {
+  lazy_collision_check_ = lazy_collision_check;
+}
+
 bool RRTStar::solve(const State &start, const State &goal) {
   // initialize sampler and node list
-  node_list_->init();
-  node_list_->add(std::make_shared<Node>(start, nullptr));
+  initPlanning(start);
+  auto goal_node = createNode(goal, nullptr);
+  goal_candidates_ = decltype(goal_candidates_)();
+  goal_edge_costs_.clear();
+  has_unreachable_nodes_ = false;
 
   // sampling on euclidean space
-  for (size_t i = 0; i < max_sampling_num_; i++) {
+  // (samples and new nodes which cannot be on a path cheaper than the best path found so far are rejected)
+  auto best_cost = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < max_sampling_num_ && !isTimeOver(); i++) {
     auto rand_node = std::make_shared<Node>(goal, nullptr, 0);
     if (goal_sampling_rate_ < sampler_->getUniformUnitRandomVal()) {
       rand_node->state = sampler_->run(Sampler::Mode::WholeArea);
+      if (!canImprove(start, goal, rand_node->state, best_cost)) {
+        statistics_.num_rejected_samples++;
+        continue;
+      }
 
       // resample when node dose not meet constraint
       if (constraint_->checkConstraintType(rand_node->state) == ConstraintType::NOENTRY) {
         continue;
       }
+      rand_node->is_valid = true;
     }
 
     // get node that is nearest neighbor node from node list and generate new
     // node
     auto nearest_node = node_list_->searchNN(rand_node);
     auto new_node = generateSteerNode(nearest_node, rand_node, expand_dist_);
+    if (!canImprove(start, goal, new_node->state, best_cost)) {
+      statistics_.num_rejected_nodes++;
+      continue;
+    }
 
     // add to list if new node meets constraint
-    if (constraint_->checkCollision(nearest_node->state, new_node->state)) {
+    if (checkCollision(nearest_node, new_node)) {
       // find nodes that exist on certain domain
-      auto nof_node = node_list_->getSize();
-      auto radius =
-          std::min(expand_dist_, R_ * std::pow((std::log(nof_node) / nof_node), 1.0 / constraint_->space.getDim()));
-      auto near_nodes = node_list_->searchNBHD(new_node, radius);
+      auto near_nodes = node_list_->searchNBHD(new_node, calcNearRadius());
 
       // choose parent node of new node from near nodes
-      updateParent(new_node, near_nodes);
+      updateParent(new_node, near_nodes, lazy_collision_check_);
 
       // add new node to list
       node_list_->add(new_node);
 
       // redefine parent node of near nodes
-      rewireNearNodes(new_node, near_nodes);
+      auto changed_cost_nodes = rewireNearNodes(new_node, near_nodes, lazy_collision_check_);
 
-      if (constraint_->checkCollision(new_node->state, goal)) {
-        auto cost_to_goal = new_node->state.distanceFrom(goal);
-        if (cost_to_goal < expand_dist_ && new_node->cost + cost_to_goal < terminate_search_cost_) {
+      // update goal candidates by nodes whose cost is new or changed
+      changed_cost_nodes.push_back(new_node);
+      for (const auto &changed_cost_node : changed_cost_nodes) {
+        pushGoalCandidate(changed_cost_node, goal_node);
+      }
+
+      const auto best_node = getBestGoalCandidate(goal_node);
+      if (best_node != nullptr) {
+        // (in lazy collision checking, the best cost may increase by repairing)
+        const auto cost = goal_candidates_.top().cost;
+        if (cost < best_cost) {
+          notifyImprovement(best_node, goal, cost);
+        }
+        best_cost = cost;
+        if (best_cost < terminate_search_cost_) {
           break;
         }
       }
+
+      // remove unreachable nodes with their descendants, so that the area is explored again by new nodes
+      if (has_unreachable_nodes_) {
+        statistics_.num_pruned_nodes += removeNodes([](const std::shared_ptr<Node> &node) {
+          return node->cost == std::numeric_limits<double>::max();
+        });
+        has_unreachable_nodes_ = false;
+      }
     }
   }
 
   // store the result
-  result_.clear();
-  auto near_goal_nodes = node_list_->searchNBHD(std::make_shared<Node>(goal, nullptr), expand_dist_);
-  if (near_goal_nodes.size() == 0) {
+  auto result_node = getBestGoalCandidate(goal_node);
+  if (result_node == nullptr) {
     return false;
-  } else {
-    std::shared_ptr<Node> result_node;
-    auto min_cost = std::numeric_limits<double>::max();
-    for (const auto &near_goal_node : near_goal_nodes) {
-      auto cost_to_goal = near_goal_node->state.distanceFrom(goal);
-      if (constraint_->checkCollision(goal, near_goal_node->state) && near_goal_node->cost + cost_to_goal < min_cost) {
-        result_node = near_goal_node;
-        min_cost = near_goal_node->cost + cost_to_goal;
+  }
+
+  result_cost_ = goal_candidates_.top().cost;
+  storeResult(result_node, goal);
+  return true;
+}
+
+void RRTStar::pushGoalCandidate(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &goal_node) {
+  if (expand_dist_ <= node->state.distanceFrom(goal_node->state) ||
+      node->cost == std::numeric_limits<double>::max()) {
+    return;
+  }
+
+  auto itr = goal_edge_costs_.find(node->id);
+  if (itr == goal_edge_costs_.end()) {
+    const auto edge_cost =
+        checkCollision(node, goal_node) ? constraint_->calcEdgeCost(node->state, goal_node->state) : -1.0;
+    itr = goal_edge_costs_.emplace(node->id, edge_cost).first;
+  }
+  if (0.0 <= itr->second) {
+    goal_candidates_.push(GoalCandidate{node->cost + itr->second, itr->second, node});
+  }
+}
+
+std::shared_ptr<Node> RRTStar::getBestGoalCandidate(const std::shared_ptr<Node> &goal_node) {
+  while (!goal_candidates_.empty()) {
+    const auto candidate = goal_candidates_.top();
+    if (candidate.node->cost + candidate.edge_cost != candidate.cost) {
+      // replace stale entry with the current cost (unless the node became unreachable)
+      goal_candidates_.pop();
+      if (candidate.node->cost != std::numeric_limits<double>::max()) {
+        goal_candidates_.push(
+            GoalCandidate{candidate.node->cost + candidate.edge_cost, candidate.edge_cost, candidate.node});
       }
+    } else if (lazy_collision_check_ && !validatePath(candidate.node, goal_node)) {
+      // the node became unreachable, so that its entry is removed as a stale one
+      // (it may be no longer on the top because repairing pushes nodes whose cost is changed)
+      continue;
+    } else if (candidate.node->cost + candidate.edge_cost == candidate.cost) {
+      // (in lazy collision checking, the cost may be increased by repairing)
+      return candidate.node;
     }
-    if (result_node == nullptr) {
-      return false;
-    } else {
-      result_cost_ = result_node->cost + result_node->state.distanceFrom(goal);
-      if (result_node->state != goal) {
-        result_.push_back(goal);
-      }
+  }
+  return nullptr;
+}
 
-      while (true) {
-        result_.insert(result_.begin(), result_node->state);
-        if (result_node->parent == nullptr) {
-          break;
+double RRTStar::calcNearRadius() const {
+  auto nof_node = node_list_->getSize();
+  return std::min(expand_dist_, R_ * std::pow((std::log(nof_node) / nof_node), 1.0 / constraint_->space.getDim()));
+}
+
+bool RRTStar::validatePath(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &goal_node) {
+  // check edges from the terminal node toward start node
+  // (after repairing, the path continues from new parent)
+  std::vector<std::shared_ptr<Node>> path;
+  auto path_node = node;
+  while (path_node->parent != nullptr) {
+    if (!path_node->is_edge_checked) {
+      if (checkCollision(path_node->parent, path_node)) {
+        path_node->is_edge_checked = true;
+      } else {
+        // if the node cannot be reconnected, reconnect the node below it instead
+        while (!repairParent(path_node, goal_node)) {
+          if (path.empty()) {
+            return false;
+          }
+          path_node = path.back();
+          path.pop_back();
         }
+      }
+    }
+    path.push_back(path_node);
+    path_node = path_node->parent;
+  }
 
-        result_node = result_node->parent;
+  // (costs on the path are already updated by repairing)
+  return true;
+}
+
+bool RRTStar::repairParent(const std::shared_ptr<Node> &node, const std::shared_ptr<Node> &goal_node) {
+  // a descendant of the node or a node under an unreachable node cannot be new parent
+  auto is_reachable = [&node](std::shared_ptr<Node> target) -> bool {
+    for (; target != nullptr; target = target->parent) {
+      if (target == node || target->cost == std::numeric_limits<double>::max()) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // try near nodes in ascending order of cost through them
+  auto radius = std::max(expand_dist_, node->state.distanceFrom(node->parent->state));
+  auto near_nodes = node_list_->searchNBHD(node, radius);
+  std::vector<std::pair<double, std::shared_ptr<Node>>> candidates;
+  for (const auto &near_node : near_nodes) {
+    if (near_node != node->parent && near_node->cost != std::numeric_limits<double>::max()) {
+      candidates.emplace_back(near_node->cost + constraint_->calcEdgeCost(near_node->state, node->state), near_node);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<double, std::shared_ptr<Node>> &a, const std::pair<double, std::shared_ptr<Node>> &b) {
+              return a.first < b.first;
+            });
+
+  for (const auto &candidate : candidates) {
+    if (is_reachable(candidate.second) && checkCollision(candidate.second, node)) {
+      std::vector<std::shared_ptr<Node>> changed_nodes;
+      changeParent(node, candidate.second, candidate.first, changed_nodes);
+      node->is_edge_checked = true;
+
+      // update goal candidates by the node and its descendants whose cost is changed
+      for (const auto &changed_node : changed_nodes) {
+        pushGoalCandidate(changed_node, goal_node);
       }
       return true;
     }
   }
+
+  // the node and its subtree become unreachable, so that they are not used as parent until repaired
+  has_unreachable_nodes_ = true;
+  std::vector<std::shared_ptr<Node>> stack{node};
+  while (!stack.empty()) {
+    const auto target = stack.back();
+    stack.pop_back();
+    target->cost = std::numeric_limits<double>::max();
+    for (const auto &child_ptr : target->children) {
+      auto child = child_ptr.lock();
+      if (child != nullptr) {
+        stack.push_back(child);
+      }
+    }
+  }
+  return false;
 }
 }  // namespace planner
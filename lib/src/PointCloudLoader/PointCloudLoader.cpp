@@ -0,0 +1,416 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <PointCloudLoader/PointCloudLoader.h>
+
+#include <cstring>
+#include <sstream>
+
+namespace planner {
+namespace {
+// remove carriage return of the files written on windows
+std::string readLine(std::ifstream &ifs) {
+  std::string line;
+  std::getline(ifs, line);
+  if (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  return line;
+}
+}  // namespace
+
+constexpr size_t PointCloudLoader::CHUNK_POINTS;
+
+PointCloudLoader::PointCloudLoader(const EuclideanSpace &space, const double &voxel_size)
+    : space_(space), voxel_size_(voxel_size) {
+  if (!(0 < voxel_size)) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Voxel size is invalid");
+  }
+
+  // number of voxels at each dimension and check that linear index never overflows
+  uint64_t total_num = 1;
+  for (size_t di = 0; di < space_.getDim(); di++) {
+    const uint64_t num = std::max(1.0, std::ceil(space_.getBound(di + 1).getRange() / voxel_size_));
+    if (std::numeric_limits<uint64_t>::max() / num < total_num) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Voxel size is too small");
+    }
+    total_num *= num;
+    each_dim_num_.push_back(num);
+  }
+}
+
+PointCloudLoader::~PointCloudLoader() {}
+
+void PointCloudLoader::clear() { voxels_.clear(); }
+
+void PointCloudLoader::addPoints(const float *data, const size_t &num_points, const uint32_t &stride) {
+  if (stride < space_.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Stride is invalid");
+  }
+
+  std::vector<double> point(space_.getDim());
+  for (size_t i = 0; i < num_points; i++) {
+    for (size_t di = 0; di < space_.getDim(); di++) {
+      point[di] = data[i * stride + di];
+    }
+    addPoint(point.data());
+  }
+}
+
+void PointCloudLoader::loadPCD(const std::string &file_path) {
+  std::ifstream ifs(file_path, std::ios::binary);
+  if (!ifs) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Can not open " + file_path);
+  }
+
+  // parse header
+  std::vector<std::string> names;
+  std::vector<size_t> sizes;
+  std::vector<char> types;
+  std::vector<size_t> counts;
+  uint64_t num_points = 0;
+  std::string data_type;
+  while (ifs && data_type.empty()) {
+    const auto line = readLine(ifs);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream iss(line);
+    std::string key;
+    iss >> key;
+    if (key == "FIELDS") {
+      for (std::string name; iss >> name;) names.push_back(name);
+    } else if (key == "SIZE") {
+      for (size_t size; iss >> size;) sizes.push_back(size);
+    } else if (key == "TYPE") {
+      for (char type; iss >> type;) types.push_back(type);
+    } else if (key == "COUNT") {
+      for (size_t count; iss >> count;) counts.push_back(count);
+    } else if (key == "POINTS") {
+      iss >> num_points;
+    } else if (key == "DATA") {
+      iss >> data_type;
+    }
+  }
+
+  if (counts.empty()) {
+    counts.assign(names.size(), 1);
+  }
+  if (names.empty() || sizes.size() != names.size() || types.size() != names.size() ||
+      counts.size() != names.size()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Header is invalid");
+  }
+
+  // offset and type of each field on a point
+  std::vector<Field> all_fields;
+  std::vector<size_t> all_columns;
+  size_t point_step = 0;
+  size_t num_values = 0;
+  for (size_t i = 0; i < names.size(); i++) {
+    ScalarType type;
+    if (types[i] == 'F' && sizes[i] == 4) {
+      type = ScalarType::FLOAT32;
+    } else if (types[i] == 'F' && sizes[i] == 8) {
+      type = ScalarType::FLOAT64;
+    } else if ((types[i] == 'I' || types[i] == 'U') && (sizes[i] == 1 || sizes[i] == 2 || sizes[i] == 4)) {
+      const auto is_signed = types[i] == 'I';
+      type = (sizes[i] == 1)   ? (is_signed ? ScalarType::INT8 : ScalarType::UINT8)
+             : (sizes[i] == 2) ? (is_signed ? ScalarType::INT16 : ScalarType::UINT16)
+                               : (is_signed ? ScalarType::INT32 : ScalarType::UINT32);
+    } else {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Type of field is not supported");
+    }
+    all_fields.push_back(Field{point_step, type});
+    all_columns.push_back(num_values);
+    point_step += sizes[i] * counts[i];
+    num_values += counts[i];
+  }
+
+  // pick up coordinate fields
+  const std::vector<std::string> axis_names{"x", "y", "z"};
+  if (axis_names.size() < space_.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of space is invalid");
+  }
+  std::vector<Field> fields;
+  std::vector<size_t> columns;
+  for (size_t di = 0; di < space_.getDim(); di++) {
+    const auto itr = std::find(names.begin(), names.end(), axis_names[di]);
+    if (itr == names.end()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Field " + axis_names[di] +
+                                  " is not found");
+    }
+    fields.push_back(all_fields[itr - names.begin()]);
+    columns.push_back(all_columns[itr - names.begin()]);
+  }
+
+  if (data_type == "binary") {
+    readBinary(ifs, num_points, point_step, fields);
+  } else if (data_type == "ascii") {
+    readAscii(ifs, num_points, num_values, columns);
+  } else {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "DATA " + data_type +
+                                " is not supported");
+  }
+}
+
+void PointCloudLoader::loadPLY(const std::string &file_path) {
+  std::ifstream ifs(file_path, std::ios::binary);
+  if (!ifs) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Can not open " + file_path);
+  } else if (readLine(ifs) != "ply") {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Header is invalid");
+  }
+
+  // parse header (element 'vertex' should be the first element)
+  std::string format;
+  uint64_t num_points = 0;
+  bool is_in_vertex = false;
+  std::vector<std::string> names;
+  std::vector<Field> all_fields;
+  size_t point_step = 0;
+  while (true) {
+    if (!ifs) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Header is invalid");
+    }
+
+    std::istringstream iss(readLine(ifs));
+    std::string key;
+    iss >> key;
+    if (key == "end_header") {
+      break;
+    } else if (key == "format") {
+      iss >> format;
+    } else if (key == "element") {
+      std::string element;
+      iss >> element;
+      if (element == "vertex" && names.empty()) {
+        iss >> num_points;
+        is_in_vertex = true;
+      } else if (element == "vertex" || num_points == 0) {
+        throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " +
+                                    "Element vertex should be the first element");
+      } else {
+        is_in_vertex = false;
+      }
+    } else if (key == "property" && is_in_vertex) {
+      std::string type_name, name;
+      iss >> type_name >> name;
+      ScalarType type;
+      if (type_name == "char" || type_name == "int8") {
+        type = ScalarType::INT8;
+      } else if (type_name == "uchar" || type_name == "uint8") {
+        type = ScalarType::UINT8;
+      } else if (type_name == "short" || type_name == "int16") {
+        type = ScalarType::INT16;
+      } else if (type_name == "ushort" || type_name == "uint16") {
+        type = ScalarType::UINT16;
+      } else if (type_name == "int" || type_name == "int32") {
+        type = ScalarType::INT32;
+      } else if (type_name == "uint" || type_name == "uint32") {
+        type = ScalarType::UINT32;
+      } else if (type_name == "float" || type_name == "float32") {
+        type = ScalarType::FLOAT32;
+      } else if (type_name == "double" || type_name == "float64") {
+        type = ScalarType::FLOAT64;
+      } else {
+        throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Property " + type_name +
+                                    " is not supported");
+      }
+      names.push_back(name);
+      all_fields.push_back(Field{point_step, type});
+      point_step += getScalarSize(type);
+    }
+  }
+
+  // pick up coordinate properties
+  const std::vector<std::string> axis_names{"x", "y", "z"};
+  if (axis_names.size() < space_.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of space is invalid");
+  }
+  std::vector<Field> fields;
+  std::vector<size_t> columns;
+  for (size_t di = 0; di < space_.getDim(); di++) {
+    const auto itr = std::find(names.begin(), names.end(), axis_names[di]);
+    if (itr == names.end()) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Property " + axis_names[di] +
+                                  " is not found");
+    }
+    fields.push_back(all_fields[itr - names.begin()]);
+    columns.push_back(itr - names.begin());
+  }
+
+  if (format == "binary_little_endian") {
+    readBinary(ifs, num_points, point_step, fields);
+  } else if (format == "ascii") {
+    readAscii(ifs, num_points, names.size(), columns);
+  } else {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Format " + format +
+                                " is not supported");
+  }
+}
+
+size_t PointCloudLoader::getNumVoxels() const { return voxels_.size(); }
+
+void PointCloudLoader::apply(PointCloudConstraint &constraint) const {
+  if (constraint.getDim() != space_.getDim()) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Dimension of constraint is invalid");
+  }
+
+  const auto radius = voxel_size_ * std::sqrt(space_.getDim()) / 2.0;
+  std::vector<PointCloudConstraint::Hypersphere> hyperspheres;
+  hyperspheres.reserve(voxels_.size());
+  for (auto key : voxels_) {
+    State center(space_.getDim());
+    for (size_t di = 0; di < space_.getDim(); di++) {
+      center.vals[di] = space_.getBound(di + 1).low + (key % each_dim_num_[di] + 0.5) * voxel_size_;
+      key /= each_dim_num_[di];
+    }
+    hyperspheres.emplace_back(center, radius);
+  }
+
+  constraint.set(std::move(hyperspheres));
+}
+
+std::shared_ptr<PointCloudConstraint> PointCloudLoader::generateConstraint() const {
+  auto constraint = std::make_shared<PointCloudConstraint>(space_);
+  apply(*constraint);
+  return constraint;
+}
+
+void PointCloudLoader::addPoint(const double *point) {
+  // linear index of voxel ('x + y * x_num + ...')
+  uint64_t key = 0;
+  uint64_t stride = 1;
+  for (size_t di = 0; di < space_.getDim(); di++) {
+    const auto bound = space_.getBound(di + 1);
+    if (!(bound.low <= point[di] && point[di] <= bound.high)) {
+      return;
+    }
+
+    const uint64_t idx = std::floor((point[di] - bound.low) / voxel_size_);
+    key += std::min(idx, each_dim_num_[di] - 1) * stride;
+    stride *= each_dim_num_[di];
+  }
+
+  voxels_.insert(key);
+}
+
+void PointCloudLoader::readBinary(std::ifstream &ifs, const uint64_t &num_points, const size_t &point_step,
+                                  const std::vector<Field> &fields) {
+  std::vector<char> buffer(CHUNK_POINTS * point_step);
+  std::vector<double> point(space_.getDim());
+  for (uint64_t read_num = 0; read_num < num_points;) {
+    const auto chunk_num = std::min<uint64_t>(CHUNK_POINTS, num_points - read_num);
+    ifs.read(buffer.data(), chunk_num * point_step);
+    if ((uint64_t)ifs.gcount() != chunk_num * point_step) {
+      throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Data is truncated");
+    }
+
+    for (size_t i = 0; i < chunk_num; i++) {
+      for (size_t di = 0; di < space_.getDim(); di++) {
+        point[di] = readScalar(&buffer[i * point_step + fields[di].offset], fields[di].type);
+      }
+      addPoint(point.data());
+    }
+    read_num += chunk_num;
+  }
+}
+
+void PointCloudLoader::readAscii(std::ifstream &ifs, const uint64_t &num_points, const size_t &num_values,
+                                 const std::vector<size_t> &columns) {
+  std::vector<double> values(num_values);
+  std::vector<double> point(space_.getDim());
+  for (uint64_t i = 0; i < num_points; i++) {
+    for (auto &value : values) {
+      if (!(ifs >> value)) {
+        throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Data is truncated");
+      }
+    }
+    for (size_t di = 0; di < space_.getDim(); di++) {
+      point[di] = values[columns[di]];
+    }
+    addPoint(point.data());
+  }
+}
+
+size_t PointCloudLoader::getScalarSize(const ScalarType &type) {
+  switch (type) {
+    case ScalarType::INT8:
+    case ScalarType::UINT8:
+      return 1;
+    case ScalarType::INT16:
+    case ScalarType::UINT16:
+      return 2;
+    case ScalarType::INT32:
+    case ScalarType::UINT32:
+    case ScalarType::FLOAT32:
+      return 4;
+    case ScalarType::FLOAT64:
+      return 8;
+  }
+  return 0;
+}
+
+double PointCloudLoader::readScalar(const char *ptr, const ScalarType &type) {
+  // binary data is little endian as same as the host
+  switch (type) {
+    case ScalarType::INT8:
+      return *reinterpret_cast<const int8_t *>(ptr);
+    case ScalarType::UINT8:
+      return *reinterpret_cast<const uint8_t *>(ptr);
+    case ScalarType::INT16: {
+      int16_t val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+    case ScalarType::UINT16: {
+      uint16_t val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+    case ScalarType::INT32: {
+      int32_t val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+    case ScalarType::UINT32: {
+      uint32_t val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+    case ScalarType::FLOAT32: {
+      float val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+    case ScalarType::FLOAT64: {
+      double val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+  }
+  return 0;
+}
+}  // namespace planner
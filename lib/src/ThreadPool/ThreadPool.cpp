@@ -0,0 +1,124 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <ThreadPool/ThreadPool.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace planner {
+ThreadPool::ThreadPool(const uint32_t &num_threads)
+    : func_(nullptr), num_(0), next_index_(0), num_running_workers_(0), generation_(0), is_terminated_(false) {
+  if (num_threads == 0) {
+    throw std::invalid_argument("[" + std::string(__PRETTY_FUNCTION__) + "] " + "Number of threads is invalid");
+  }
+
+  for (uint32_t i = 1; i < num_threads; i++) {
+    workers_.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_terminated_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+uint32_t ThreadPool::getNumThreads() const { return workers_.size() + 1; }
+
+void ThreadPool::parallelFor(const size_t &num, const std::function<void(const size_t &)> &func) {
+  if (num == 0) {
+    return;
+  } else if (num == 1 || workers_.empty()) {
+    for (size_t i = 0; i < num; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> call_lock(call_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    func_ = &func;
+    num_ = num;
+    next_index_ = 0;
+    num_running_workers_ = workers_.size();
+    exception_ = nullptr;
+    generation_++;
+  }
+  start_cv_.notify_all();
+
+  runLoop();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [&]() { return num_running_workers_ == 0; });
+  func_ = nullptr;
+  if (exception_ != nullptr) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+void ThreadPool::work() {
+  uint64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [&]() { return is_terminated_ || generation != generation_; });
+      if (is_terminated_) {
+        return;
+      }
+      generation = generation_;
+    }
+
+    runLoop();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      num_running_workers_--;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+void ThreadPool::runLoop() {
+  size_t i;
+  while ((i = next_index_++) < num_) {
+    try {
+      (*func_)(i);
+    } catch (...) {
+      // the remaining indices are skipped
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (exception_ == nullptr) {
+        exception_ = std::current_exception();
+      }
+      next_index_ = num_;
+    }
+  }
+}
+}  // namespace planner
@@ -0,0 +1,118 @@
+/**
+ *  MIT License
+ *
+ *  Copyright (c) 2019 Yuya Kudo
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <planner.h>
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// lazy collision checking of RRT* on cluttered maps
+// (solve() has to finish, the parent chain of every node has to reach start node
+//  and every edge of the result has to meet constraint)
+int main() {
+  constexpr int NUM_MAPS = 10;
+  constexpr size_t NUM_CIRCLES = 300;
+  constexpr double CIRCLE_RADIUS = 2.0;
+
+  planner::EuclideanSpace space(2);
+  std::vector<planner::Bound> bounds{planner::Bound(0.0, 100.0), planner::Bound(0.0, 100.0)};
+  space.setBound(bounds);
+
+  const planner::State start(5.0, 5.0);
+  const planner::State goal(95.0, 95.0);
+
+  auto num_failures = 0;
+  auto num_solved_maps = 0;
+  for (int map = 0; map < NUM_MAPS; map++) {
+    std::mt19937 rand(map);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::vector<planner::PointCloudConstraint::Hypersphere> circles;
+    while (circles.size() < NUM_CIRCLES) {
+      planner::State center(dist(rand), dist(rand));
+      if (CIRCLE_RADIUS < center.distanceFrom(start) && CIRCLE_RADIUS < center.distanceFrom(goal)) {
+        circles.emplace_back(center, CIRCLE_RADIUS);
+      }
+    }
+
+    const auto constraint = std::make_shared<planner::PointCloudConstraint>(space, circles);
+    planner::RRTStar rrt_star(2, 20000, 0.05, 10, 50);
+    rrt_star.setProblemDefinition(constraint);
+    rrt_star.setLazyCollisionCheck(true);
+    const auto is_solved = rrt_star.solve(start, goal);
+    num_solved_maps += is_solved ? 1 : 0;
+
+    // all nodes are in the neighborhood of start node whose radius is the diagonal of space
+    const auto diagonal = planner::State(0.0, 0.0).distanceFrom(planner::State(100.0, 100.0));
+    const auto node_list = rrt_star.getNodeList();
+    const auto nodes = node_list->searchNBHD(std::make_shared<planner::Node>(start, nullptr), diagonal);
+    if (nodes.size() != (size_t)node_list->getSize()) {
+      std::cerr << "map " << map << ": " << nodes.size() << " of " << node_list->getSize() << " nodes are listed"
+                << std::endl;
+      num_failures++;
+    }
+
+    // (a chain longer than the number of nodes has a cycle)
+    size_t num_invalid_nodes = 0;
+    for (const auto &node : nodes) {
+      auto root = node;
+      size_t depth = 0;
+      while (root->parent != nullptr && depth <= nodes.size()) {
+        root = root->parent;
+        depth++;
+      }
+      if (root->parent != nullptr || root->state != start) {
+        num_invalid_nodes++;
+      }
+    }
+
+    if (num_invalid_nodes != 0) {
+      std::cerr << "map " << map << ": " << num_invalid_nodes << " of " << nodes.size()
+                << " nodes do not reach start node" << std::endl;
+      num_failures++;
+    }
+
+    // edges of the result are accepted without collision check until they are validated
+    const auto &result = rrt_star.getResult();
+    if (is_solved && (result.empty() || result.front() != start || result.back() != goal)) {
+      std::cerr << "map " << map << ": result does not connect start and goal" << std::endl;
+      num_failures++;
+    }
+    for (size_t i = 1; i < result.size(); i++) {
+      if (!constraint->checkCollision(result[i - 1], result[i])) {
+        std::cerr << "map " << map << ": edge " << i << " of the result does not meet constraint" << std::endl;
+        num_failures++;
+      }
+    }
+  }
+
+  // (maps are solvable, so that results are checked in most of them)
+  if (num_solved_maps < NUM_MAPS / 2) {
+    std::cerr << "only " << num_solved_maps << " of " << NUM_MAPS << " maps are solved" << std::endl;
+    num_failures++;
+  }
+
+  return (num_failures == 0) ? 0 : 1;
+}